@@ -6,13 +6,18 @@
 #include "ITMMainEngine.h"
 #include "ITMTrackingController.h"
 #include "../Engines/LowLevel/Interface/ITMLowLevelEngine.h"
+#include "../Engines/Meshing/CPU/ITMMeshDecimationEngine_CPU.h"
 #include "../Engines/Meshing/Interface/ITMMeshingEngine.h"
 #include "../Engines/ViewBuilding/Interface/ITMViewBuilder.h"
 #include "../Engines/Visualisation/Interface/ITMVisualisationEngine.h"
 #include "../Objects/Misc/ITMIMUCalibrator.h"
+#include "../Utils/ITMBackgroundWorker.h"
 
 #include "../../FernRelocLib/Relocaliser.h"
 
+#include <string>
+#include <vector>
+
 namespace ITMLib
 {
 	template <typename TVoxel, typename TIndex>
@@ -28,6 +33,26 @@ namespace ITMLib
 		ITMVisualisationEngine<TVoxel, TIndex> *visualisationEngine;
 
 		ITMMeshingEngine<TVoxel, TIndex> *meshingEngine;
+		ITMMeshDecimationEngine_CPU *meshDecimationEngine;
+
+		/// Meshes a snapshot of the scene with its own meshing engine, on the background worker
+		class MeshingTask : public ITMBackgroundWorker::Task
+		{
+		private:
+			ITMBasicEngine *engine;
+			ITMMeshingEngine<TVoxel, TIndex> *meshingEngine;
+			ITMScene<TVoxel, TIndex> *snapshot;
+			std::string fileName;
+
+		public:
+			MeshingTask(ITMBasicEngine *engine, ITMMeshingEngine<TVoxel, TIndex> *meshingEngine, ITMScene<TVoxel, TIndex> *snapshot, const char *fileName)
+				: engine(engine), meshingEngine(meshingEngine), snapshot(snapshot), fileName(fileName) { }
+			~MeshingTask(void) { delete snapshot; delete meshingEngine; }
+
+			void Run(void) { engine->WriteSceneMesh(fileName.c_str(), meshingEngine, snapshot, NULL); }
+		};
+
+		ITMBackgroundWorker *meshingWorker;
 
 		ITMViewBuilder *viewBuilder;
 		ITMDenseMapper<TVoxel, TIndex> *denseMapper;
@@ -36,6 +61,7 @@ namespace ITMLib
 		ITMScene<TVoxel, TIndex> *scene;
 		ITMRenderState *renderState_live;
 		ITMRenderState *renderState_freeview;
+		ITMRenderState *renderState_batch;
 
 		ITMTracker *tracker;
 		ITMIMUCalibrator *imuCalibrator;
@@ -49,6 +75,49 @@ namespace ITMLib
 		/// Pointer to the current camera pose and additional tracking information
 		ITMTrackingState *trackingState;
 
+		/// Advanced whenever fusion may have changed the scene content seen by the cached free camera image
+		unsigned int sceneEpoch;
+
+		/// Last free camera image, reused by GetImage while pose, intrinsics, image type and scene epoch are unchanged
+		ITMUChar4Image *freeviewCache;
+		Matrix4f freeviewCache_M;
+		Vector4f freeviewCache_projParams;
+		GetImageType freeviewCache_type;
+		unsigned int freeviewCache_epoch;
+		bool freeviewCache_valid;
+
+		/// Per hash entry flags marking the blocks visible in the cached free camera image
+		std::vector<uchar> freeviewCache_visibleEntries;
+		std::vector<int> visibleEntryIDs_host;
+
+		/// Advances the scene epoch if the last fusion step touched blocks visible in the cached free camera image
+		void UpdateSceneEpoch(int lastFreeBlockId_beforeFusion);
+
+		/// Remembers the current free camera rendering in the cache
+		void StoreFreeviewCache(const ORUtils::SE3Pose *pose, const ITMIntrinsics *intrinsics, GetImageType getImageType);
+
+		/** Meshes the whole scene, or only the region if one is given,
+		    with the given meshing engine and writes the mesh to the file.
+		    Called from the background worker for snapshots, so it must
+		    not touch the live scene or any other per frame state.
+		*/
+		void WriteSceneMesh(const char *fileName, ITMMeshingEngine<TVoxel, TIndex> *meshingEngine, const ITMScene<TVoxel, TIndex> *scene,
+			const ITMMeshRegion *region);
+
+		/// Simplifies the mesh as configured in the settings, if decimation is enabled
+		void DecimateMesh(ITMIndexedMesh *mesh);
+
+		/// Raycasts a batch of free camera views, sharing one visible list between consecutive nearby poses
+		void RenderBatch(const ORUtils::SE3Pose *poses, const ITMIntrinsics *intrinsics, int noPoses,
+			ITMUChar4Image **outColour, IITMVisualisationEngine::RenderImageType type, ITMFloatImage **outDepth);
+
+		/** Relocalises by tracking the current frame from each of the
+		    given keyframes, and from the last good pose if the failed
+		    tracking started from a different, predicted pose, and
+		    keeps the pose with the best tracking result.
+		*/
+		void RelocaliseFromHypotheses(const ORUtils::SE3Pose &lastGoodPose, const std::vector<int> &keyframeIds);
+
 	public:
 		ITMView* GetView(void) { return view; }
 		ITMTrackingState* GetTrackingState(void) { return trackingState; }
@@ -61,6 +130,32 @@ namespace ITMLib
 		/// Extracts a mesh from the current scene and saves it to the model file specified by the file name
 		void SaveSceneToMesh(const char *fileName);
 
+		/// Extracts the mesh of the part of the scene inside an axis-aligned box or camera frustum and saves it as above
+		void SaveSceneToMesh(const char *fileName, const ITMMeshRegion &region);
+
+		/** Copies the allocated part of the scene and meshes the copy on
+		    a separate thread, so that frames can be processed while the
+		    mesh is written. The mesh shows the scene as it is when this
+		    is called. Returns false if the previous background export
+		    has not finished yet, or the index does not support it.
+		*/
+		bool SaveSceneToMeshInBackground(const char *fileName);
+
+		/// Whether a mesh export started by SaveSceneToMeshInBackground is still running
+		bool IsSavingSceneInBackground(void) const { return meshingWorker->IsBusy(); }
+
+		/// Waits for the mesh export started by SaveSceneToMeshInBackground, if any, to finish
+		void WaitForBackgroundSave(void) { meshingWorker->Wait(); }
+
+		/** Meshes the scene in tiles of tileSize^3 voxel blocks and
+		    writes each tile as binary PLY files to the directory, one
+		    per level of detail. Level l samples every 2^l-th voxel,
+		    for up to four levels. The index of tiles, levels and files
+		    is written to tiles.json in the same directory, which may
+		    be given with or without a trailing separator.
+		*/
+		void SaveSceneToTiledMesh(const std::string &outputDirectory, int tileSize = 32, int noLevels = 3);
+
 		/// save and load the full scene and relocaliser (if any) to/from file
 		void SaveToFile();
 		void LoadFromFile();
@@ -70,6 +165,9 @@ namespace ITMLib
 
 		void GetImage(ITMUChar4Image *out, GetImageType getImageType, ORUtils::SE3Pose *pose = NULL, ITMIntrinsics *intrinsics = NULL);
 
+		void GetImages(ITMUChar4Image **out, GetImageType getImageType, const ORUtils::SE3Pose *poses, const ITMIntrinsics *intrinsics, int noPoses);
+		void GetDepthImages(ITMFloatImage **out, const ORUtils::SE3Pose *poses, const ITMIntrinsics *intrinsics, int noPoses);
+
 		/// switch for turning tracking on/off
 		void turnOnTracking();
 		void turnOffTracking();
@@ -36,6 +36,12 @@ ITMBasicEngine<TVoxel,TIndex>::ITMBasicEngine(const ITMLibSettings *settings, co
 	if (settings->createMeshingEngine)
 		meshingEngine = ITMMeshingEngineFactory::MakeMeshingEngine<TVoxel,TIndex>(deviceType);
 
+	meshDecimationEngine = NULL;
+	if (settings->createMeshingEngine && settings->decimateMeshes)
+		meshDecimationEngine = new ITMMeshDecimationEngine_CPU();
+
+	meshingWorker = new ITMBackgroundWorker();
+
 	denseMapper = new ITMDenseMapper<TVoxel,TIndex>(settings);
 	denseMapper->ResetScene(scene);
 
@@ -47,6 +53,11 @@ ITMBasicEngine<TVoxel,TIndex>::ITMBasicEngine(const ITMLibSettings *settings, co
 
 	renderState_live = ITMRenderStateFactory<TIndex>::CreateRenderState(trackedImageSize, scene->sceneParams, memoryType);
 	renderState_freeview = NULL; //will be created if needed
+	renderState_batch = NULL; //will be created if needed
+
+	sceneEpoch = 0;
+	freeviewCache = NULL; //will be created if needed
+	freeviewCache_valid = false;
 
 	trackingState = new ITMTrackingState(trackedImageSize, memoryType);
 	tracker->UpdateInitialPose(trackingState);
@@ -70,8 +81,13 @@ ITMBasicEngine<TVoxel,TIndex>::ITMBasicEngine(const ITMLibSettings *settings, co
 template <typename TVoxel, typename TIndex>
 ITMBasicEngine<TVoxel,TIndex>::~ITMBasicEngine()
 {
+	// lets a background export finish first, it uses the settings and the decimation engine
+	delete meshingWorker;
+
 	delete renderState_live;
 	if (renderState_freeview != NULL) delete renderState_freeview;
+	if (renderState_batch != NULL) delete renderState_batch;
+	if (freeviewCache != NULL) delete freeviewCache;
 
 	delete scene;
 
@@ -93,17 +109,152 @@ ITMBasicEngine<TVoxel,TIndex>::~ITMBasicEngine()
 	delete kfRaycast;
 
 	if (meshingEngine != NULL) delete meshingEngine;
+	if (meshDecimationEngine != NULL) delete meshDecimationEngine;
 }
 
 template <typename TVoxel, typename TIndex>
 void ITMBasicEngine<TVoxel,TIndex>::SaveSceneToMesh(const char *objFileName)
+{
+	WriteSceneMesh(objFileName, meshingEngine, scene, NULL);
+}
+
+template <typename TVoxel, typename TIndex>
+void ITMBasicEngine<TVoxel,TIndex>::SaveSceneToMesh(const char *fileName, const ITMMeshRegion &region)
+{
+	WriteSceneMesh(fileName, meshingEngine, scene, &region);
+}
+
+template <typename TVoxel, typename TIndex>
+bool ITMBasicEngine<TVoxel,TIndex>::SaveSceneToMeshInBackground(const char *fileName)
+{
+	if (meshingEngine == NULL || meshingWorker->IsBusy()) return false;
+
+	// taken here, between frames, so that fusion cannot change the scene while it is copied
+	ITMScene<TVoxel,TIndex> *snapshot = meshingEngine->MakeSceneSnapshot(scene);
+	if (snapshot == NULL) return false;
+
+	MeshingTask *task = new MeshingTask(this, ITMMeshingEngineFactory::MakeMeshingEngine<TVoxel,TIndex>(settings->deviceType), snapshot, fileName);
+	if (!meshingWorker->Start(task))
+	{
+		delete task;
+		return false;
+	}
+
+	return true;
+}
+
+template <typename TVoxel, typename TIndex>
+void ITMBasicEngine<TVoxel,TIndex>::SaveSceneToTiledMesh(const std::string &outputDirectory, int tileSize, int noLevels)
+{
+	if (meshingEngine == NULL) return;
+
+	// strides beyond the block size would skip whole blocks
+	noLevels = CLAMP(noLevels, 1, 4);
+	float blockSize = scene->sceneParams->voxelSize * SDF_BLOCK_SIZE, tileExtent = blockSize * tileSize;
+
+	std::vector<Vector3i> tiles;
+	meshingEngine->FindOccupiedTiles(tiles, scene, tileSize);
+
+	// the file names are appended to the directory, so it needs a trailing separator
+	std::string directory = outputDirectory;
+	if (!directory.empty() && directory[directory.size() - 1] != '/' && directory[directory.size() - 1] != '\\') directory += '/';
+
+	MakeDir(directory.c_str());
+
+	std::string manifestFileName = directory + "tiles.json";
+	FILE *manifest = fopen(manifestFileName.c_str(), "w");
+	if (manifest == NULL) throw std::runtime_error("Could not open " + manifestFileName + " for writing");
+
+	fprintf(manifest, "{\n\t\"voxelSize\": %g,\n\t\"tileSize\": %g,\n\t\"levels\": [", scene->sceneParams->voxelSize, tileExtent);
+	for (int level = 0; level < noLevels; level++) fprintf(manifest, "%s{ \"level\": %d, \"voxelStride\": %d }", level > 0 ? ", " : " ", level, 1 << level);
+	fprintf(manifest, " ],\n\t\"tiles\": [");
+
+	ITMIndexedMesh mesh;
+	bool firstTile = true;
+
+	for (size_t tileId = 0; tileId < tiles.size(); tileId++)
+	{
+		const Vector3i &tile = tiles[tileId];
+		Vector3f tileMin = tile.toFloat() * tileExtent, tileMax = tileMin + Vector3f(tileExtent);
+
+		// shrunk by half a block, so that the blocks on the tile's boundary overlap this tile only
+		ITMMeshRegion region(tileMin + Vector3f(0.5f * blockSize), tileMax - Vector3f(0.5f * blockSize));
+
+		bool firstFile = true;
+		for (int level = 0; level < noLevels; level++)
+		{
+			meshingEngine->MeshScene(&mesh, scene, region, 1 << level);
+			DecimateMesh(&mesh);
+			if (mesh.faces.empty()) continue;
+
+			char fileName[96];
+			sprintf(fileName, "tile_%d_%d_%d_lod%d.ply", tile.x, tile.y, tile.z, level);
+			mesh.WritePLY((directory + fileName).c_str());
+
+			if (firstFile)
+			{
+				fprintf(manifest, "%s\n\t\t{ \"tile\": [%d, %d, %d], \"min\": [%g, %g, %g], \"max\": [%g, %g, %g], \"files\": [", firstTile ? "" : ",",
+					tile.x, tile.y, tile.z, tileMin.x, tileMin.y, tileMin.z, tileMax.x, tileMax.y, tileMax.z);
+				firstTile = false;
+			}
+
+			fprintf(manifest, "%s\n\t\t\t{ \"level\": %d, \"file\": \"%s\", \"vertices\": %d, \"faces\": %d }", firstFile ? "" : ",",
+				level, fileName, (int)mesh.vertices.size(), (int)mesh.faces.size());
+			firstFile = false;
+		}
+
+		if (!firstFile) fprintf(manifest, " ] }");
+	}
+
+	fprintf(manifest, " ]\n}\n");
+	fclose(manifest);
+}
+
+template <typename TVoxel, typename TIndex>
+void ITMBasicEngine<TVoxel,TIndex>::DecimateMesh(ITMIndexedMesh *mesh)
+{
+	if (meshDecimationEngine == NULL) return;
+
+	size_t targetNoFaces = (size_t)(settings->meshDecimationRatio * mesh->faces.size());
+	if (settings->meshDecimationRatio > 0.0f) targetNoFaces = MAX(targetNoFaces, (size_t)1);
+
+	meshDecimationEngine->Decimate(mesh, targetNoFaces, settings->meshDecimationMaxError);
+}
+
+template <typename TVoxel, typename TIndex>
+void ITMBasicEngine<TVoxel,TIndex>::WriteSceneMesh(const char *fileName, ITMMeshingEngine<TVoxel,TIndex> *meshingEngine,
+	const ITMScene<TVoxel,TIndex> *scene, const ITMMeshRegion *region)
 {
 	if (meshingEngine == NULL) return;
 
+	if (settings->streamMeshes && region == NULL)
+	{
+		ITMMeshWriter writer;
+		if (!writer.Open(fileName)) throw std::runtime_error("Could not open " + std::string(fileName) + " for writing");
+
+		meshingEngine->MeshScene(&writer, scene);
+		writer.Close();
+		return;
+	}
+
+	if (ITMIndexedMesh::HasPLYExtension(fileName))
+	{
+		ITMIndexedMesh indexedMesh;
+		if (region != NULL) meshingEngine->MeshScene(&indexedMesh, scene, *region);
+		else meshingEngine->MeshScene(&indexedMesh, scene);
+		DecimateMesh(&indexedMesh);
+		indexedMesh.WritePLY(fileName);
+		return;
+	}
+
 	ITMMesh *mesh = new ITMMesh(settings->GetMemoryType());
 
-	meshingEngine->MeshScene(mesh, scene);
-	mesh->WriteSTL(objFileName);
+	if (region != NULL) meshingEngine->MeshScene(mesh, scene, *region);
+	else meshingEngine->MeshScene(mesh, scene);
+	if (mesh->noDroppedTriangles > 0)
+		fprintf(stderr, "warning: mesh exceeds %u triangles, %u triangles were dropped\n", mesh->noMaxTriangles, mesh->noDroppedTriangles);
+
+	mesh->WriteSTL(fileName);
 
 	delete mesh;
 }
@@ -153,6 +304,7 @@ void ITMBasicEngine<TVoxel, TIndex>::LoadFromFile()
 	try // load scene
 	{
 		scene->LoadFromDirectory(sceneInputDirectory);
+		sceneEpoch++;
 	}
 	catch (std::runtime_error &e)
 	{
@@ -166,6 +318,7 @@ void ITMBasicEngine<TVoxel,TIndex>::resetAll()
 {
 	denseMapper->ResetScene(scene);
 	trackingState->Reset();
+	sceneEpoch++;
 }
 
 #ifdef OUTPUT_TRAJECTORY_QUATERNIONS
@@ -248,6 +401,9 @@ ITMTrackingState::TrackingResult ITMBasicEngine<TVoxel,TIndex>::ProcessFrame(ITM
 	if (imuMeasurement == NULL) viewBuilder->UpdateView(&view, rgbImage, rawDepthImage, settings->useBilateralFilter);
 	else viewBuilder->UpdateView(&view, rgbImage, rawDepthImage, settings->useBilateralFilter, imuMeasurement);
 
+	// the motion model must not extrapolate across frames that were not tracked
+	if (!mainProcessingActive || !trackingActive) trackingState->hasPreviousPose = false;
+
 	if (!mainProcessingActive) return ITMTrackingState::TRACKING_FAILED;
 
 	// tracking
@@ -274,11 +430,12 @@ ITMTrackingState::TrackingResult ITMBasicEngine<TVoxel,TIndex>::ProcessFrame(ITM
 	{
 		if (trackerResult == ITMTrackingState::TRACKING_GOOD && relocalisationCount > 0) relocalisationCount--;
 
-		int NN; float distances;
+		int noNN = settings->useMultiHypothesisRelocalisation ? MAX(settings->noRelocalisationHypotheses, 1) : 1;
+		std::vector<int> NN(noNN); std::vector<float> distances(noNN);
 		view->depth->UpdateHostFromDevice();
 
 		//find and add keyframe, if necessary
-		bool hasAddedKeyframe = relocaliser->ProcessFrame(view->depth, trackingState->pose_d, 0, 1, &NN, &distances, trackerResult == ITMTrackingState::TRACKING_GOOD && relocalisationCount == 0);
+		bool hasAddedKeyframe = relocaliser->ProcessFrame(view->depth, trackingState->pose_d, 0, noNN, &NN[0], &distances[0], trackerResult == ITMTrackingState::TRACKING_GOOD && relocalisationCount == 0);
 
 		//frame not added and tracking failed -> we need to relocalise
 		if (!hasAddedKeyframe && trackerResult == ITMTrackingState::TRACKING_FAILED)
@@ -288,12 +445,19 @@ ITMTrackingState::TrackingResult ITMBasicEngine<TVoxel,TIndex>::ProcessFrame(ITM
 			// Reset previous rgb frame since the rgb image is likely different than the one acquired when setting the keyframe
 			view->rgb_prev->Clear();
 
-			const FernRelocLib::PoseDatabase::PoseInScene & keyframe = relocaliser->RetrievePose(NN);
-			trackingState->pose_d->SetFrom(&keyframe.pose);
+			if (settings->useMultiHypothesisRelocalisation) RelocaliseFromHypotheses(oldPose, NN);
+			else
+			{
+				const FernRelocLib::PoseDatabase::PoseInScene & keyframe = relocaliser->RetrievePose(NN[0]);
+				trackingState->pose_d->SetFrom(&keyframe.pose);
 
-			denseMapper->UpdateVisibleList(view, trackingState, scene, renderState_live, true);
-			trackingController->Prepare(trackingState, scene, view, visualisationEngine, renderState_live); 
-			trackingController->Track(trackingState, view);
+				denseMapper->UpdateVisibleList(view, trackingState, scene, renderState_live, true);
+				trackingController->Prepare(trackingState, scene, view, visualisationEngine, renderState_live); 
+				trackingController->Track(trackingState, view);
+			}
+
+			// the jump to the relocalised pose is no motion the next frame should continue
+			trackingState->hasPreviousPose = false;
 
 			trackerResult = trackingState->trackerResult;
 		}
@@ -302,7 +466,9 @@ ITMTrackingState::TrackingResult ITMBasicEngine<TVoxel,TIndex>::ProcessFrame(ITM
 	bool didFusion = false;
 	if ((trackerResult == ITMTrackingState::TRACKING_GOOD || !trackingInitialised) && (fusionActive) && (relocalisationCount == 0)) {
 		// fusion
+		int lastFreeBlockId = scene->localVBA.lastFreeBlockId;
 		denseMapper->ProcessFrame(view, trackingState, scene, renderState_live);
+		UpdateSceneEpoch(lastFreeBlockId);
 		didFusion = true;
 		if (framesProcessed > 50) trackingInitialised = true;
 
@@ -341,6 +507,61 @@ ITMTrackingState::TrackingResult ITMBasicEngine<TVoxel,TIndex>::ProcessFrame(ITM
     return trackerResult;
 }
 
+template <typename TVoxel, typename TIndex>
+void ITMBasicEngine<TVoxel,TIndex>::RelocaliseFromHypotheses(const ORUtils::SE3Pose &lastGoodPose, const std::vector<int> &keyframeIds)
+{
+	std::vector<ORUtils::SE3Pose> hypotheses;
+	for (size_t i = 0; i < keyframeIds.size(); i++)
+		if (keyframeIds[i] >= 0) hypotheses.push_back(relocaliser->RetrievePose(keyframeIds[i]).pose);
+
+	// tracking from the last good pose itself has only been tried if no motion model predicted a different one
+	if (trackingState->pose_predicted->GetM() != lastGoodPose.GetM()) hypotheses.push_back(lastGoodPose);
+
+	if (hypotheses.empty()) return;
+
+	ORUtils::SE3Pose bestPose;
+	ITMTrackingState::TrackingResult bestResult = ITMTrackingState::TRACKING_FAILED;
+	float bestScore = 0.0f;
+	int bestHypothesisId = -1;
+
+	// each hypothesis tracks the same frame, which must only advance the frame count once
+	int framesProcessed = trackingState->framesProcessed;
+
+	for (int hypothesisId = 0; hypothesisId < (int)hypotheses.size(); hypothesisId++)
+	{
+		trackingState->pose_d->SetFrom(&hypotheses[hypothesisId]);
+		trackingState->framesProcessed = framesProcessed;
+
+		// neither the motion model nor the coarse level skipping may use the failed frame
+		trackingState->trackerResult = ITMTrackingState::TRACKING_FAILED;
+		trackingState->hasPreviousPose = false;
+		trackingState->trackerScore = 0.0f;
+
+		denseMapper->UpdateVisibleList(view, trackingState, scene, renderState_live, true);
+		trackingController->Prepare(trackingState, scene, view, visualisationEngine, renderState_live);
+		trackingController->Track(trackingState, view);
+
+		// the hypotheses are ordered from the most similar keyframe on, which wins ties
+		if (bestHypothesisId < 0 || trackingState->trackerResult > bestResult ||
+			(trackingState->trackerResult == bestResult && trackingState->trackerScore > bestScore))
+		{
+			bestPose.SetFrom(trackingState->pose_d);
+			bestResult = trackingState->trackerResult;
+			bestScore = trackingState->trackerScore;
+			bestHypothesisId = hypothesisId;
+		}
+	}
+
+	if (bestHypothesisId != (int)hypotheses.size() - 1)
+	{
+		trackingState->pose_d->SetFrom(&bestPose);
+		denseMapper->UpdateVisibleList(view, trackingState, scene, renderState_live, true);
+	}
+
+	trackingState->trackerResult = bestResult;
+	trackingState->trackerScore = bestScore;
+}
+
 template <typename TVoxel, typename TIndex>
 Vector2i ITMBasicEngine<TVoxel,TIndex>::GetImageSize(void) const
 {
@@ -417,6 +638,13 @@ void ITMBasicEngine<TVoxel,TIndex>::GetImage(ITMUChar4Image *out, GetImageType g
 		else if (getImageType == ITMBasicEngine::InfiniTAM_IMAGE_FREECAMERA_COLOUR_FROM_NORMAL) type = IITMVisualisationEngine::RENDER_COLOUR_FROM_NORMAL;
 		else if (getImageType == ITMBasicEngine::InfiniTAM_IMAGE_FREECAMERA_COLOUR_FROM_CONFIDENCE) type = IITMVisualisationEngine::RENDER_COLOUR_FROM_CONFIDENCE;
 
+		if (freeviewCache_valid && freeviewCache_epoch == sceneEpoch && freeviewCache_type == getImageType && freeviewCache->noDims == out->noDims &&
+			freeviewCache_M == pose->GetM() && freeviewCache_projParams == intrinsics->projectionParamsSimple.all)
+		{
+			out->SetFrom(freeviewCache, ORUtils::MemoryBlock<Vector4u>::CPU_TO_CPU);
+			break;
+		}
+
 		if (renderState_freeview == NULL)
 		{
 			renderState_freeview = ITMRenderStateFactory<TIndex>::CreateRenderState(out->noDims, scene->sceneParams, settings->GetMemoryType());
@@ -429,6 +657,9 @@ void ITMBasicEngine<TVoxel,TIndex>::GetImage(ITMUChar4Image *out, GetImageType g
 		if (settings->deviceType == ITMLibSettings::DEVICE_CUDA)
 			out->SetFrom(renderState_freeview->raycastImage, ORUtils::MemoryBlock<Vector4u>::CUDA_TO_CPU);
 		else out->SetFrom(renderState_freeview->raycastImage, ORUtils::MemoryBlock<Vector4u>::CPU_TO_CPU);
+
+		StoreFreeviewCache(pose, intrinsics, getImageType);
+		if (freeviewCache_valid) freeviewCache->SetFrom(out, ORUtils::MemoryBlock<Vector4u>::CPU_TO_CPU);
 		break;
 	}
 	case ITMMainEngine::InfiniTAM_IMAGE_UNKNOWN:
@@ -436,6 +667,170 @@ void ITMBasicEngine<TVoxel,TIndex>::GetImage(ITMUChar4Image *out, GetImageType g
 	};
 }
 
+template <typename TVoxel, typename TIndex>
+void ITMBasicEngine<TVoxel,TIndex>::UpdateSceneEpoch(int lastFreeBlockId_beforeFusion)
+{
+	if (!freeviewCache_valid) return;
+
+	// without a visible list, with swapping (which may remove blocks anywhere) or
+	// if new blocks were allocated (which may lie inside the cached view), we
+	// have to assume that the cached image is outdated
+	const ITMRenderState_VH *renderState_vh = dynamic_cast<const ITMRenderState_VH*>(renderState_live);
+	if (renderState_vh == NULL || freeviewCache_visibleEntries.empty() || settings->swappingMode != ITMLibSettings::SWAPPINGMODE_DISABLED ||
+		scene->localVBA.lastFreeBlockId != lastFreeBlockId_beforeFusion)
+	{
+		sceneEpoch++;
+		return;
+	}
+
+	// otherwise only the blocks integrated into are modified
+	int noVisibleEntries = renderState_vh->noVisibleEntries;
+	visibleEntryIDs_host.resize(noVisibleEntries);
+	renderState_vh->CopyVisibleEntryIDsToHost(visibleEntryIDs_host.data());
+
+	for (int entryNo = 0; entryNo < noVisibleEntries; ++entryNo)
+	{
+		if (freeviewCache_visibleEntries[visibleEntryIDs_host[entryNo]])
+		{
+			sceneEpoch++;
+			return;
+		}
+	}
+}
+
+template <typename TVoxel, typename TIndex>
+void ITMBasicEngine<TVoxel,TIndex>::StoreFreeviewCache(const ORUtils::SE3Pose *pose, const ITMIntrinsics *intrinsics, GetImageType getImageType)
+{
+	freeviewCache_valid = false;
+
+	const ITMRenderState_VH *renderState_vh = dynamic_cast<const ITMRenderState_VH*>(renderState_freeview);
+	if (renderState_vh != NULL)
+	{
+		int noVisibleEntries = renderState_vh->noVisibleEntries;
+		visibleEntryIDs_host.resize(noVisibleEntries);
+		renderState_vh->CopyVisibleEntryIDsToHost(visibleEntryIDs_host.data());
+
+		freeviewCache_visibleEntries.assign(ITMVoxelBlockHash::noTotalEntries, 0);
+		for (int entryNo = 0; entryNo < noVisibleEntries; ++entryNo) freeviewCache_visibleEntries[visibleEntryIDs_host[entryNo]] = 1;
+	}
+	else freeviewCache_visibleEntries.clear();
+
+	if (freeviewCache == NULL) freeviewCache = new ITMUChar4Image(renderState_freeview->raycastImage->noDims, MEMORYDEVICE_CPU);
+
+	freeviewCache_M = pose->GetM();
+	freeviewCache_projParams = intrinsics->projectionParamsSimple.all;
+	freeviewCache_type = getImageType;
+	freeviewCache_epoch = sceneEpoch;
+	freeviewCache_valid = true;
+}
+
+// consecutive batch poses are only grouped onto one visible list if they stay this close to the first pose of the group
+static const int batchGroup_maxSize = 16;
+static const float batchGroup_maxTranslation = 0.25f; // metres
+static const float batchGroup_minViewCosine = 0.985f; // about 10 degrees
+
+static bool IsNearbyBatchPose(const ORUtils::SE3Pose & groupPose, const ITMIntrinsics & groupIntrinsics, const Vector2i & groupSize,
+	const ORUtils::SE3Pose & pose, const ITMIntrinsics & intrinsics, const Vector2i & imgSize)
+{
+	if (groupSize != imgSize || groupIntrinsics.projectionParamsSimple.all != intrinsics.projectionParamsSimple.all) return false;
+
+	Matrix4f groupInvM = groupPose.GetInvM(), invM = pose.GetInvM();
+	Vector3f groupCentre = groupInvM.getColumn(3).toVector3(), centre = invM.getColumn(3).toVector3();
+	Vector3f groupAxis = groupInvM.getColumn(2).toVector3(), axis = invM.getColumn(2).toVector3();
+
+	if (length(centre - groupCentre) > batchGroup_maxTranslation) return false;
+	return dot(axis, groupAxis) >= batchGroup_minViewCosine;
+}
+
+template <typename TVoxel, typename TIndex>
+void ITMBasicEngine<TVoxel,TIndex>::RenderBatch(const ORUtils::SE3Pose *poses, const ITMIntrinsics *intrinsics, int noPoses,
+	ITMUChar4Image **outColour, IITMVisualisationEngine::RenderImageType type, ITMFloatImage **outDepth)
+{
+	bool useCUDA = settings->deviceType == ITMLibSettings::DEVICE_CUDA;
+	ITMFloat4Image *raycastResult_host = NULL;
+
+	for (int groupStart = 0; groupStart < noPoses; )
+	{
+		Vector2i imgSize = outColour != NULL ? outColour[groupStart]->noDims : outDepth[groupStart]->noDims;
+
+		int groupEnd = groupStart + 1;
+		while (groupEnd < noPoses && groupEnd - groupStart < batchGroup_maxSize)
+		{
+			Vector2i nextSize = outColour != NULL ? outColour[groupEnd]->noDims : outDepth[groupEnd]->noDims;
+			if (!IsNearbyBatchPose(poses[groupStart], intrinsics[groupStart], imgSize, poses[groupEnd], intrinsics[groupEnd], nextSize)) break;
+			groupEnd++;
+		}
+
+		if (renderState_batch != NULL && renderState_batch->raycastResult->noDims != imgSize)
+		{
+			delete renderState_batch;
+			renderState_batch = NULL;
+		}
+		if (renderState_batch == NULL)
+			renderState_batch = ITMRenderStateFactory<TIndex>::CreateRenderState(imgSize, scene->sceneParams, settings->GetMemoryType());
+
+		// one pass over the index for the whole group, the blocks outside a
+		// particular view are then rejected when projecting the expected depths
+		visualisationEngine->FindVisibleBlocks(scene, poses + groupStart, groupEnd - groupStart, &intrinsics[groupStart], renderState_batch);
+
+		for (int poseIdx = groupStart; poseIdx < groupEnd; ++poseIdx)
+		{
+			const ORUtils::SE3Pose *pose = &poses[poseIdx];
+
+			visualisationEngine->CreateExpectedDepths(scene, pose, &intrinsics[poseIdx], renderState_batch);
+
+			if (outColour != NULL)
+			{
+				visualisationEngine->RenderImage(scene, pose, &intrinsics[poseIdx], renderState_batch, renderState_batch->raycastImage, type);
+
+				if (useCUDA) outColour[poseIdx]->SetFrom(renderState_batch->raycastImage, ORUtils::MemoryBlock<Vector4u>::CUDA_TO_CPU);
+				else outColour[poseIdx]->SetFrom(renderState_batch->raycastImage, ORUtils::MemoryBlock<Vector4u>::CPU_TO_CPU);
+			}
+			else visualisationEngine->FindSurface(scene, pose, &intrinsics[poseIdx], renderState_batch);
+
+			if (outDepth != NULL)
+			{
+				const ITMFloat4Image *raycastResult = renderState_batch->raycastResult;
+				if (useCUDA)
+				{
+					if (raycastResult_host == NULL) raycastResult_host = new ITMFloat4Image(imgSize, MEMORYDEVICE_CPU);
+					raycastResult_host->ChangeDims(imgSize);
+					raycastResult_host->SetFrom(raycastResult, ORUtils::MemoryBlock<Vector4f>::CUDA_TO_CPU);
+					raycastResult = raycastResult_host;
+				}
+
+				IITMVisualisationEngine::RaycastToDepth(outDepth[poseIdx], raycastResult, pose->GetM(), scene->sceneParams->voxelSize);
+			}
+		}
+
+		groupStart = groupEnd;
+	}
+
+	if (raycastResult_host != NULL) delete raycastResult_host;
+}
+
+template <typename TVoxel, typename TIndex>
+void ITMBasicEngine<TVoxel,TIndex>::GetImages(ITMUChar4Image **out, GetImageType getImageType, const ORUtils::SE3Pose *poses, const ITMIntrinsics *intrinsics, int noPoses)
+{
+	IITMVisualisationEngine::RenderImageType type;
+	switch (getImageType)
+	{
+	case ITMBasicEngine::InfiniTAM_IMAGE_FREECAMERA_SHADED: type = IITMVisualisationEngine::RENDER_SHADED_GREYSCALE; break;
+	case ITMBasicEngine::InfiniTAM_IMAGE_FREECAMERA_COLOUR_FROM_VOLUME: type = IITMVisualisationEngine::RENDER_COLOUR_FROM_VOLUME; break;
+	case ITMBasicEngine::InfiniTAM_IMAGE_FREECAMERA_COLOUR_FROM_NORMAL: type = IITMVisualisationEngine::RENDER_COLOUR_FROM_NORMAL; break;
+	case ITMBasicEngine::InfiniTAM_IMAGE_FREECAMERA_COLOUR_FROM_CONFIDENCE: type = IITMVisualisationEngine::RENDER_COLOUR_FROM_CONFIDENCE; break;
+	default: return;
+	}
+
+	RenderBatch(poses, intrinsics, noPoses, out, type, NULL);
+}
+
+template <typename TVoxel, typename TIndex>
+void ITMBasicEngine<TVoxel,TIndex>::GetDepthImages(ITMFloatImage **out, const ORUtils::SE3Pose *poses, const ITMIntrinsics *intrinsics, int noPoses)
+{
+	RenderBatch(poses, intrinsics, noPoses, NULL, IITMVisualisationEngine::RENDER_SHADED_GREYSCALE, out);
+}
+
 template <typename TVoxel, typename TIndex>
 void ITMBasicEngine<TVoxel,TIndex>::turnOnTracking() { trackingActive = true; }
 
@@ -76,7 +76,18 @@ namespace ITMLib
 
 		virtual void GetImage(ITMUChar4Image *out, GetImageType getImageType, ORUtils::SE3Pose *pose = NULL, ITMIntrinsics *intrinsics = NULL) = 0;
 
-		/// Extracts a mesh from the current scene and saves it to the model file specified by the file name
+		/** Renders free camera images for a batch of poses, using
+		    poses[i] and intrinsics[i] for out[i]. The output images are
+		    provided by the caller and rendered at their current size.
+		    Only the InfiniTAM_IMAGE_FREECAMERA_* image types are supported.
+		*/
+		virtual void GetImages(ITMUChar4Image **out, GetImageType getImageType, const ORUtils::SE3Pose *poses, const ITMIntrinsics *intrinsics, int noPoses) { }
+
+		/// Renders free camera depth images (in metres, -1 where no surface was hit) for a batch of poses
+		virtual void GetDepthImages(ITMFloatImage **out, const ORUtils::SE3Pose *poses, const ITMIntrinsics *intrinsics, int noPoses) { }
+
+		/// Extracts a mesh from the current scene and saves it to the model file specified by the file name,
+		/// as binary PLY with shared vertices if the name ends in .ply and as STL otherwise
 		virtual void SaveSceneToMesh(const char *fileName) { };
 
 		/// save and load the full scene and relocaliser (if any) to/from file
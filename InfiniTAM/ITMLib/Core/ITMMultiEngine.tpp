@@ -304,8 +304,23 @@ void ITMMultiEngine<TVoxel, TIndex>::SaveSceneToMesh(const char *modelFileName)
 
 	ITMMesh *mesh = new ITMMesh(settings->GetMemoryType());
 
-	meshingEngine->MeshScene(mesh, *mapManager);
-	mesh->WriteSTL(modelFileName);
+	meshingEngine->MeshScene(mesh, *mapManager, settings->deduplicateMapOverlaps);
+	if (mesh->noDroppedTriangles > 0)
+		fprintf(stderr, "warning: mesh exceeds %u triangles, %u triangles were dropped\n", mesh->noMaxTriangles, mesh->noDroppedTriangles);
+
+	if (ITMIndexedMesh::HasPLYExtension(modelFileName))
+	{
+		// local maps overlap, so vertices are welded by position across the whole mesh rather than by cell edge
+		ORUtils::MemoryBlock<ITMMesh::Triangle> cpu_triangles(mesh->GetCapacity(), MEMORYDEVICE_CPU);
+		if (mesh->memoryType == MEMORYDEVICE_CUDA) cpu_triangles.SetFrom(mesh->triangles, ORUtils::MemoryBlock<ITMMesh::Triangle>::CUDA_TO_CPU);
+		else cpu_triangles.SetFrom(mesh->triangles, ORUtils::MemoryBlock<ITMMesh::Triangle>::CPU_TO_CPU);
+
+		ITMIndexedMesh indexedMesh;
+		indexedMesh.SetFromTriangles(cpu_triangles.GetData(MEMORYDEVICE_CPU), mesh->noTotalTriangles);
+		indexedMesh.ComputeNormalsFromFaces();
+		indexedMesh.WritePLY(modelFileName);
+	}
+	else mesh->WriteSTL(modelFileName);
 	
 	delete mesh;
 }
@@ -19,11 +19,64 @@ namespace ITMLib
 		const ITMLibSettings *settings;
 		ITMTracker *tracker;
 
+		/** Predicts the pose of the next frame by applying the
+		    motion from pose_previous to pose_d again, or the
+		    decayed fraction of it. Returns false if the motion model
+		    is disabled or the motion is not known.
+		*/
+		bool PredictPose(const ITMTrackingState *trackingState, ORUtils::SE3Pose *predictedPose) const
+		{
+			if (settings->motionModel == ITMLibSettings::MOTIONMODEL_NONE || !trackingState->hasPreviousPose) return false;
+
+			// after a failure or a relocalisation the previous pose says nothing about the motion
+			if (trackingState->trackerResult != ITMTrackingState::TRACKING_GOOD) return false;
+
+			ORUtils::SE3Pose motion(trackingState->pose_d->GetM() * trackingState->pose_previous->GetInvM());
+
+			if (settings->motionModel == ITMLibSettings::MOTIONMODEL_DECAYING_VELOCITY)
+			{
+				Vector3f translation, rotation;
+				motion.GetParams(translation, rotation);
+				motion.SetFrom(translation * settings->motionModelDecay, rotation * settings->motionModelDecay);
+			}
+
+			predictedPose->SetM(motion.GetM() * trackingState->pose_d->GetM());
+			return true;
+		}
+
+		/** Whether the point cloud should be raycast in full rather
+		    than forward rendered: as well as when the camera has moved
+		    away from the point cloud, this is the case when the pose
+		    predicted for the next frame will have moved away from it.
+		*/
+		bool RequiresFullRendering(const ITMTrackingState *trackingState) const
+		{
+			if (!settings->useApproximateRaycast || trackingState->TrackerFarFromPointCloud()) return true;
+
+			ORUtils::SE3Pose predictedPose;
+			return PredictPose(trackingState, &predictedPose) && trackingState->PoseFarFromPointCloud(&predictedPose);
+		}
+
 	public:
+		/** Tracks the camera, starting from the pose predicted by the
+		    motion model if one is enabled. The starting pose is kept in
+		    pose_predicted, so that it can be compared with the tracked
+		    pose_d. Frames that are not tracked reset the motion.
+		*/
 		void Track(ITMTrackingState *trackingState, const ITMView *view)
 		{
 			if (!tracker->requiresPointCloudRendering() || trackingState->age_pointCloud != -1)
+			{
+				if (!PredictPose(trackingState, trackingState->pose_predicted)) trackingState->pose_predicted->SetFrom(trackingState->pose_d);
+
+				trackingState->pose_previous->SetFrom(trackingState->pose_d);
+				trackingState->hasPreviousPose = true;
+
+				trackingState->pose_d->SetFrom(trackingState->pose_predicted);
+				trackingState->lastTrackerResult = trackingState->trackerResult;
 				tracker->TrackCamera(trackingState, view);
+			}
+			else trackingState->hasPreviousPose = false;
 		}
 
 		template <typename TSurfel>
@@ -35,7 +88,7 @@ namespace ITMLib
 
 			//render for tracking
 			bool requiresColourRendering = tracker->requiresColourRendering();
-			bool requiresFullRendering = trackingState->TrackerFarFromPointCloud() || !settings->useApproximateRaycast;
+			bool requiresFullRendering = RequiresFullRendering(trackingState);
 
 			if(requiresColourRendering)
 			{
@@ -71,7 +124,7 @@ namespace ITMLib
 
 			//render for tracking
 			bool requiresColourRendering = tracker->requiresColourRendering();
-			bool requiresFullRendering = trackingState->TrackerFarFromPointCloud() || !settings->useApproximateRaycast;
+			bool requiresFullRendering = RequiresFullRendering(trackingState);
 
 			if (requiresColourRendering)
 			{
@@ -86,7 +139,7 @@ namespace ITMLib
 
 				if (requiresFullRendering)
 				{
-					visualisationEngine->CreateICPMaps(scene, view, trackingState, renderState);
+					visualisationEngine->CreateICPMaps(scene, view, trackingState, renderState, settings->icpRaycastSubsample);
 					trackingState->pose_pointCloud->SetFrom(trackingState->pose_d);
 					if (trackingState->age_pointCloud==-1) trackingState->age_pointCloud=-2;
 					else trackingState->age_pointCloud = 0;
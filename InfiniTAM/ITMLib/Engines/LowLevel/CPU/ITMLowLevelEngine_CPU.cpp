@@ -6,6 +6,130 @@
 
 using namespace ITMLib;
 
+/// Number of image rows the fused pyramid passes process together, and hand to a thread at once
+static const int noRowsPerBand = 16;
+
+/** Runs a pass that builds one pyramid level, given as a Filter
+    method writing a row of the subsampled image and a Gradient
+    method computing the gradients of a row from the filtered rows
+    above and below it. The gradients of the inner rows of a band
+    are computed while the band is being filtered and still in the
+    cache. The two edge rows of each band also need rows of the
+    neighbouring bands, so they wait until all bands are filtered.
+*/
+template <class TPyramidPass>
+static void runFusedPyramidPass(const TPyramidPass &pass, int noRows)
+{
+	int noBands = (noRows + noRowsPerBand - 1) / noRowsPerBand;
+
+#ifdef WITH_OPENMP
+	#pragma omp parallel
+#endif
+	{
+#ifdef WITH_OPENMP
+		#pragma omp for
+#endif
+		for (int bandId = 0; bandId < noBands; bandId++)
+		{
+			int firstRow = bandId * noRowsPerBand, endRow = MIN(firstRow + noRowsPerBand, noRows);
+
+			for (int y = firstRow; y < endRow; y++)
+			{
+				pass.Filter(y);
+				if (y - 1 > firstRow) pass.Gradient(y - 1);
+			}
+		}
+
+#ifdef WITH_OPENMP
+		#pragma omp for
+#endif
+		for (int bandId = 0; bandId < noBands; bandId++)
+		{
+			int firstRow = bandId * noRowsPerBand, endRow = MIN(firstRow + noRowsPerBand, noRows);
+
+			pass.Gradient(firstRow);
+			if (endRow - 1 > firstRow) pass.Gradient(endRow - 1);
+		}
+	}
+}
+
+/// Subsampling of a colour image fused with its X and Y gradients, as FilterSubsample, GradientX and GradientY compute them
+struct ColourPyramidPass
+{
+	const Vector4u *image_in;
+	Vector4u *image_out;
+	Vector4s *gradX, *gradY;
+	Vector2i oldDims, newDims;
+
+	// the members are copied to locals first, as the compiler cannot tell that the writes to the images leave them unchanged
+
+	void Filter(int y) const
+	{
+		const Vector4u *in = image_in; Vector4u *out = image_out;
+		const Vector2i inDims = oldDims, outDims = newDims;
+
+		for (int x = 0; x < outDims.x; x++) filterSubsample(out, x, y, outDims, in, inDims);
+	}
+
+	void Gradient(int y) const
+	{
+		const Vector4u *image = image_out; Vector4s *gX = gradX, *gY = gradY;
+		const Vector2i imgSize = newDims;
+
+		if (y == 0 || y == imgSize.y - 1)
+		{
+			for (int x = 0; x < imgSize.x; x++) gX[y * imgSize.x + x] = gY[y * imgSize.x + x] = Vector4s((short)0);
+			return;
+		}
+
+		gX[y * imgSize.x] = gY[y * imgSize.x] = gX[y * imgSize.x + imgSize.x - 1] = gY[y * imgSize.x + imgSize.x - 1] = Vector4s((short)0);
+
+		for (int x = 1; x < imgSize.x - 1; x++) gradientX(gX, x, y, image, imgSize);
+		for (int x = 1; x < imgSize.x - 1; x++) gradientY(gY, x, y, image, imgSize);
+	}
+};
+
+/// Subsampling of an intensity image fused with its gradients, as FilterSubsample and GradientXY compute them
+struct IntensityPyramidPass
+{
+	const float *image_in;
+	float *image_out;
+	Vector2f *grad;
+	Vector2i oldDims, newDims;
+
+	void Filter(int y) const
+	{
+		const float *in = image_in; float *out = image_out;
+		const Vector2i inDims = oldDims, outDims = newDims;
+
+		if (y == 0 || y == outDims.y - 1)
+		{
+			for (int x = 0; x < outDims.x; x++) out[y * outDims.x + x] = 0.0f;
+			return;
+		}
+
+		out[y * outDims.x] = out[y * outDims.x + outDims.x - 1] = 0.0f;
+
+		for (int x = 1; x < outDims.x - 1; x++) boxFilter2x2(out, x, y, outDims, in, x * 2, y * 2, inDims);
+	}
+
+	void Gradient(int y) const
+	{
+		const float *image = image_out; Vector2f *g = grad;
+		const Vector2i imgSize = newDims;
+
+		if (y == 0 || y == imgSize.y - 1)
+		{
+			for (int x = 0; x < imgSize.x; x++) g[y * imgSize.x + x] = Vector2f(0.0f);
+			return;
+		}
+
+		g[y * imgSize.x] = g[y * imgSize.x + imgSize.x - 1] = Vector2f(0.0f);
+
+		for (int x = 1; x < imgSize.x - 1; x++) gradientXY(g, x, y, image, imgSize);
+	}
+};
+
 ITMLowLevelEngine_CPU::ITMLowLevelEngine_CPU(void) { }
 ITMLowLevelEngine_CPU::~ITMLowLevelEngine_CPU(void) { }
 
@@ -41,6 +165,9 @@ void ITMLowLevelEngine_CPU::ConvertColourToIntensity(ITMFloatImage *image_out, c
 	float *dest = image_out->GetData(MEMORYDEVICE_CPU);
 	const Vector4u *src = image_in->GetData(MEMORYDEVICE_CPU);
 
+#ifdef WITH_OPENMP
+	#pragma omp parallel for
+#endif
 	for (int y = 0; y < dims.y; y++) for (int x = 0; x < dims.x; x++)
 		convertColourToIntensity(dest, x, y, dims, src);
 }
@@ -55,6 +182,9 @@ void ITMLowLevelEngine_CPU::FilterIntensity(ITMFloatImage *image_out, const ITMF
 	const float *imageData_in = image_in->GetData(MEMORYDEVICE_CPU);
 	float *imageData_out = image_out->GetData(MEMORYDEVICE_CPU);
 
+#ifdef WITH_OPENMP
+	#pragma omp parallel for
+#endif
 	for (int y = 2; y < dims.y - 2; y++) for (int x = 2; x < dims.x - 2; x++)
 		boxFilter2x2(imageData_out, x, y, dims, imageData_in, x, y, dims);
 }
@@ -69,6 +199,9 @@ void ITMLowLevelEngine_CPU::FilterSubsample(ITMUChar4Image *image_out, const ITM
 	const Vector4u *imageData_in = image_in->GetData(MEMORYDEVICE_CPU);
 	Vector4u *imageData_out = image_out->GetData(MEMORYDEVICE_CPU);
 
+#ifdef WITH_OPENMP
+	#pragma omp parallel for
+#endif
 	for (int y = 0; y < newDims.y; y++) for (int x = 0; x < newDims.x; x++)
 		filterSubsample(imageData_out, x, y, newDims, imageData_in, oldDims);
 }
@@ -84,6 +217,9 @@ void ITMLowLevelEngine_CPU::FilterSubsample(ITMFloatImage *image_out, const ITMF
 	const float *imageData_in = image_in->GetData(MEMORYDEVICE_CPU);
 	float *imageData_out = image_out->GetData(MEMORYDEVICE_CPU);
 
+#ifdef WITH_OPENMP
+	#pragma omp parallel for
+#endif
 	for (int y = 1; y < newDims.y - 1; y++) for (int x = 1; x < newDims.x - 1; x++)
 		boxFilter2x2(imageData_out, x, y, newDims, imageData_in, x * 2, y * 2, oldDims);
 }
@@ -98,6 +234,9 @@ void ITMLowLevelEngine_CPU::FilterSubsampleWithHoles(ITMFloatImage *image_out, c
 	const float *imageData_in = image_in->GetData(MEMORYDEVICE_CPU);
 	float *imageData_out = image_out->GetData(MEMORYDEVICE_CPU);
 
+#ifdef WITH_OPENMP
+	#pragma omp parallel for
+#endif
 	for (int y = 0; y < newDims.y; y++) for (int x = 0; x < newDims.x; x++)
 		filterSubsampleWithHoles(imageData_out, x, y, newDims, imageData_in, oldDims);
 }
@@ -112,10 +251,48 @@ void ITMLowLevelEngine_CPU::FilterSubsampleWithHoles(ITMFloat4Image *image_out,
 	const Vector4f *imageData_in = image_in->GetData(MEMORYDEVICE_CPU);
 	Vector4f *imageData_out = image_out->GetData(MEMORYDEVICE_CPU);
 
+#ifdef WITH_OPENMP
+	#pragma omp parallel for
+#endif
 	for (int y = 0; y < newDims.y; y++) for (int x = 0; x < newDims.x; x++)
 		filterSubsampleWithHoles(imageData_out, x, y, newDims, imageData_in, oldDims);
 }
 
+void ITMLowLevelEngine_CPU::FilterSubsampleWithGradients(ITMUChar4Image *image_out, ITMShort4Image *gradX_out, ITMShort4Image *gradY_out,
+	const ITMUChar4Image *image_in) const
+{
+	ColourPyramidPass pass;
+	pass.oldDims = image_in->noDims;
+	pass.newDims = Vector2i(image_in->noDims.x / 2, image_in->noDims.y / 2);
+
+	image_out->ChangeDims(pass.newDims);
+	gradX_out->ChangeDims(pass.newDims);
+	gradY_out->ChangeDims(pass.newDims);
+
+	pass.image_in = image_in->GetData(MEMORYDEVICE_CPU);
+	pass.image_out = image_out->GetData(MEMORYDEVICE_CPU);
+	pass.gradX = gradX_out->GetData(MEMORYDEVICE_CPU);
+	pass.gradY = gradY_out->GetData(MEMORYDEVICE_CPU);
+
+	runFusedPyramidPass(pass, pass.newDims.y);
+}
+
+void ITMLowLevelEngine_CPU::FilterSubsampleWithGradients(ITMFloatImage *image_out, ITMFloat2Image *grad_out, const ITMFloatImage *image_in) const
+{
+	IntensityPyramidPass pass;
+	pass.oldDims = image_in->noDims;
+	pass.newDims = Vector2i(image_in->noDims.x / 2, image_in->noDims.y / 2);
+
+	image_out->ChangeDims(pass.newDims);
+	grad_out->ChangeDims(pass.newDims);
+
+	pass.image_in = image_in->GetData(MEMORYDEVICE_CPU);
+	pass.image_out = image_out->GetData(MEMORYDEVICE_CPU);
+	pass.grad = grad_out->GetData(MEMORYDEVICE_CPU);
+
+	runFusedPyramidPass(pass, pass.newDims.y);
+}
+
 void ITMLowLevelEngine_CPU::GradientX(ITMShort4Image *grad_out, const ITMUChar4Image *image_in) const
 {
 	grad_out->ChangeDims(image_in->noDims);
@@ -126,6 +303,9 @@ void ITMLowLevelEngine_CPU::GradientX(ITMShort4Image *grad_out, const ITMUChar4I
 
 	memset(grad, 0, imgSize.x * imgSize.y * sizeof(Vector4s));
 
+#ifdef WITH_OPENMP
+	#pragma omp parallel for
+#endif
 	for (int y = 1; y < imgSize.y - 1; y++) for (int x = 1; x < imgSize.x - 1; x++)
 		gradientX(grad, x, y, image, imgSize);
 }
@@ -140,6 +320,9 @@ void ITMLowLevelEngine_CPU::GradientY(ITMShort4Image *grad_out, const ITMUChar4I
 
 	memset(grad, 0, imgSize.x * imgSize.y * sizeof(Vector4s));
 
+#ifdef WITH_OPENMP
+	#pragma omp parallel for
+#endif
 	for (int y = 1; y < imgSize.y - 1; y++) for (int x = 1; x < imgSize.x - 1; x++)
 		gradientY(grad, x, y, image, imgSize);
 }
@@ -153,6 +336,9 @@ void ITMLowLevelEngine_CPU::GradientXY(ITMFloat2Image *grad_out, const ITMFloatI
 	Vector2f *grad = grad_out->GetData(MEMORYDEVICE_CPU);
 	const float *image = image_in->GetData(MEMORYDEVICE_CPU);
 
+#ifdef WITH_OPENMP
+	#pragma omp parallel for
+#endif
 	for (int y = 1; y < imgSize.y - 1; y++) for (int x = 1; x < imgSize.x - 1; x++)
 		gradientXY(grad, x, y, image, imgSize);
 }
@@ -162,6 +348,9 @@ int ITMLowLevelEngine_CPU::CountValidDepths(const ITMFloatImage *image_in) const
 	int noValidPoints = 0;
 	const float *imageData_in = image_in->GetData(MEMORYDEVICE_CPU);
 
+#ifdef WITH_OPENMP
+	#pragma omp parallel for reduction(+:noValidPoints)
+#endif
 	for (int i = 0; i < image_in->noDims.x * image_in->noDims.y; ++i) if (imageData_in[i] > 0.0) noValidPoints++;
 
 	return noValidPoints;
@@ -22,6 +22,10 @@ namespace ITMLib
 		void FilterSubsampleWithHoles(ITMFloatImage *image_out, const ITMFloatImage *image_in) const;
 		void FilterSubsampleWithHoles(ITMFloat4Image *image_out, const ITMFloat4Image *image_in) const;
 
+		void FilterSubsampleWithGradients(ITMUChar4Image *image_out, ITMShort4Image *gradX_out, ITMShort4Image *gradY_out,
+			const ITMUChar4Image *image_in) const;
+		void FilterSubsampleWithGradients(ITMFloatImage *image_out, ITMFloat2Image *grad_out, const ITMFloatImage *image_in) const;
+
 		void GradientX(ITMShort4Image *grad_out, const ITMUChar4Image *image_in) const;
 		void GradientY(ITMShort4Image *grad_out, const ITMUChar4Image *image_in) const;
 		void GradientXY(ITMFloat2Image *grad_out, const ITMFloatImage *image_in) const;
@@ -163,6 +163,20 @@ void ITMLowLevelEngine_CUDA::FilterSubsampleWithHoles(ITMFloat4Image *image_out,
 	ORcudaKernelCheck;
 }
 
+void ITMLowLevelEngine_CUDA::FilterSubsampleWithGradients(ITMUChar4Image *image_out, ITMShort4Image *gradX_out, ITMShort4Image *gradY_out,
+	const ITMUChar4Image *image_in) const
+{
+	FilterSubsample(image_out, image_in);
+	GradientX(gradX_out, image_out);
+	GradientY(gradY_out, image_out);
+}
+
+void ITMLowLevelEngine_CUDA::FilterSubsampleWithGradients(ITMFloatImage *image_out, ITMFloat2Image *grad_out, const ITMFloatImage *image_in) const
+{
+	FilterSubsample(image_out, image_in);
+	GradientXY(grad_out, image_out);
+}
+
 void ITMLowLevelEngine_CUDA::GradientX(ITMShort4Image *grad_out, const ITMUChar4Image *image_in) const
 {
 	grad_out->ChangeDims(image_in->noDims);
@@ -23,6 +23,15 @@ namespace ITMLib
 		virtual void FilterSubsampleWithHoles(ITMFloatImage *image_out, const ITMFloatImage *image_in) const = 0;
 		virtual void FilterSubsampleWithHoles(ITMFloat4Image *image_out, const ITMFloat4Image *image_in) const = 0;
 
+		/** Subsample the image as FilterSubsample does and compute
+		    the gradients of the result, as GradientX and GradientY or
+		    GradientXY do, which builds one level of a tracker's image
+		    pyramid in a single call.
+		*/
+		virtual void FilterSubsampleWithGradients(ITMUChar4Image *image_out, ITMShort4Image *gradX_out, ITMShort4Image *gradY_out,
+			const ITMUChar4Image *image_in) const = 0;
+		virtual void FilterSubsampleWithGradients(ITMFloatImage *image_out, ITMFloat2Image *grad_out, const ITMFloatImage *image_in) const = 0;
+
 		virtual void GradientX(ITMShort4Image *grad_out, const ITMUChar4Image *image_in) const = 0;
 		virtual void GradientY(ITMShort4Image *grad_out, const ITMUChar4Image *image_in) const = 0;
 		virtual void GradientXY(ITMFloat2Image *grad_out, const ITMFloatImage *image_in) const = 0;
@@ -0,0 +1,392 @@
+// Copyright 2014-2017 Oxford University Innovation Limited and the authors of InfiniTAM
+
+#include "ITMMeshDecimationEngine_CPU.h"
+
+#include <cfloat>
+
+using namespace ITMLib;
+
+/// Sum of squared distances to a set of planes, as the upper triangle of a symmetric 4x4 matrix
+struct Quadric
+{
+	double a[10];
+
+	Quadric(void) { for (int i = 0; i < 10; i++) a[i] = 0.0; }
+
+	/// Adds the plane dot(n, x) + d = 0, for unit normal n
+	void AddPlane(const Vector3f &n, float d)
+	{
+		double nx = n.x, ny = n.y, nz = n.z, dd = d;
+		a[0] += nx * nx; a[1] += nx * ny; a[2] += nx * nz; a[3] += nx * dd;
+		a[4] += ny * ny; a[5] += ny * nz; a[6] += ny * dd;
+		a[7] += nz * nz; a[8] += nz * dd;
+		a[9] += dd * dd;
+	}
+
+	void Add(const Quadric &q)
+	{
+		for (int i = 0; i < 10; i++) a[i] += q.a[i];
+	}
+
+	double Evaluate(const Vector3f &p) const
+	{
+		double x = p.x, y = p.y, z = p.z;
+		return a[0] * x * x + 2.0 * a[1] * x * y + 2.0 * a[2] * x * z + 2.0 * a[3] * x
+			+ a[4] * y * y + 2.0 * a[5] * y * z + 2.0 * a[6] * y
+			+ a[7] * z * z + 2.0 * a[8] * z + a[9];
+	}
+
+	/// Point of least error, if the planes constrain it in all three directions
+	bool Minimise(Vector3f &p) const
+	{
+		double c00 = a[4] * a[7] - a[5] * a[5], c01 = a[2] * a[5] - a[1] * a[7], c02 = a[1] * a[5] - a[2] * a[4];
+		double c11 = a[0] * a[7] - a[2] * a[2], c12 = a[1] * a[2] - a[0] * a[5], c22 = a[0] * a[4] - a[1] * a[1];
+
+		double det = a[0] * c00 + a[1] * c01 + a[2] * c02;
+		double meanEigenvalue = (a[0] + a[4] + a[7]) / 3.0;
+		if (fabs(det) <= 1e-3 * meanEigenvalue * meanEigenvalue * meanEigenvalue) return false;
+
+		p.x = (float)(-(c00 * a[3] + c01 * a[6] + c02 * a[8]) / det);
+		p.y = (float)(-(c01 * a[3] + c11 * a[6] + c12 * a[8]) / det);
+		p.z = (float)(-(c02 * a[3] + c12 * a[6] + c22 * a[8]) / det);
+		return true;
+	}
+};
+
+struct EdgeCollapse
+{
+	double cost;
+	Vector3f position;
+	int keptVertex, removedVertex;
+};
+
+/// Collapse number collapseId of the vertex, ordered by cost, with the vertex ids breaking ties
+struct CollapseCandidate
+{
+	double cost;
+	int vertex, collapseId;
+
+	bool operator<(const CollapseCandidate &other) const
+	{
+		if (cost != other.cost) return cost < other.cost;
+		if (vertex != other.vertex) return vertex < other.vertex;
+		return collapseId < other.collapseId;
+	}
+};
+
+/// Faces around a collapsed edge must not turn by more than this, as cosine of the angle
+static const float minFaceCosine = 0.2f;
+
+static void removeDegenerateFaces(std::vector<Vector3i> &faces)
+{
+	size_t noFaces = 0;
+	for (size_t i = 0; i < faces.size(); i++)
+	{
+		const Vector3i &f = faces[i];
+		if (f.x == f.y || f.y == f.z || f.z == f.x) continue;
+		faces[noFaces++] = f;
+	}
+	faces.resize(noFaces);
+}
+
+/// Lists the faces around each vertex, in ascending order, as faceIds[faceStart[v]] to faceIds[faceStart[v + 1] - 1]
+static void buildVertexFaces(const std::vector<Vector3i> &faces, int noVertices, std::vector<int> &faceStart, std::vector<int> &faceIds)
+{
+	faceStart.assign(noVertices + 1, 0);
+	for (size_t i = 0; i < faces.size(); i++)
+	{
+		faceStart[faces[i].x + 1]++; faceStart[faces[i].y + 1]++; faceStart[faces[i].z + 1]++;
+	}
+	for (int v = 0; v < noVertices; v++) faceStart[v + 1] += faceStart[v];
+
+	std::vector<int> fillPos(faceStart.begin(), faceStart.end() - 1);
+	faceIds.resize(faces.size() * 3);
+	for (size_t i = 0; i < faces.size(); i++)
+	{
+		faceIds[fillPos[faces[i].x]++] = (int)i; faceIds[fillPos[faces[i].y]++] = (int)i; faceIds[fillPos[faces[i].z]++] = (int)i;
+	}
+}
+
+/** Writes the neighbours of v in ascending order to neighbours, with the
+    number of faces around v that contain each of them, and returns how many
+    there are. Both arrays need room for two entries per face around v.
+*/
+static int collectNeighbours(int *neighbours, int *noSharedFaces, int v, const std::vector<Vector3i> &faces, const std::vector<int> &faceStart,
+	const std::vector<int> &faceIds)
+{
+	int noEntries = 0;
+	for (int i = faceStart[v]; i < faceStart[v + 1]; i++)
+	{
+		const Vector3i &f = faces[faceIds[i]];
+		for (int j = 0; j < 3; j++) if (f[j] != v) neighbours[noEntries++] = f[j];
+	}
+	std::sort(neighbours, neighbours + noEntries);
+
+	int noNeighbours = 0;
+	for (int i = 0; i < noEntries; )
+	{
+		int j = i + 1;
+		while (j < noEntries && neighbours[j] == neighbours[i]) j++;
+
+		neighbours[noNeighbours] = neighbours[i];
+		noSharedFaces[noNeighbours++] = j - i;
+		i = j;
+	}
+	return noNeighbours;
+}
+
+/// Whether moving v to newPosition keeps all faces around it, other than those on the collapsed edge, facing the same way
+static bool keepsOrientation(int v, int otherVertex, const Vector3f &newPosition, const std::vector<Vector3f> &vertices, const std::vector<Vector3i> &faces,
+	const std::vector<int> &faceStart, const std::vector<int> &faceIds)
+{
+	for (int i = faceStart[v]; i < faceStart[v + 1]; i++)
+	{
+		const Vector3i &f = faces[faceIds[i]];
+		if (f.x == otherVertex || f.y == otherVertex || f.z == otherVertex) continue;
+
+		Vector3f p[3], q[3];
+		for (int j = 0; j < 3; j++) { p[j] = vertices[f[j]]; q[j] = f[j] == v ? newPosition : p[j]; }
+
+		Vector3f oldNormal = cross(p[1] - p[0], p[2] - p[0]), newNormal = cross(q[1] - q[0], q[2] - q[0]);
+		float oldNorm = sqrt(dot(oldNormal, oldNormal)), newNorm = sqrt(dot(newNormal, newNormal));
+		if (newNorm == 0.0f) return false;
+		if (oldNorm > 0.0f && dot(oldNormal, newNormal) < minFaceCosine * oldNorm * newNorm) return false;
+	}
+	return true;
+}
+
+/// Finds where to collapse the edge between v0 and v1 to, given the neighbours of both, and whether that is allowed
+static bool evaluateCollapse(EdgeCollapse &collapse, int v0, int v1, const int *neighbours0, int noNeighbours0, const int *neighbours1, int noNeighbours1, double maxCost,
+	const std::vector<Vector3f> &vertices, const std::vector<Vector3i> &faces, const std::vector<int> &faceStart, const std::vector<int> &faceIds,
+	const std::vector<char> &onBoundary, const std::vector<Quadric> &quadrics)
+{
+	// boundary vertices stay where they are, so only edges with at most one of them can be collapsed, onto that one
+	if (onBoundary[v0] && onBoundary[v1]) return false;
+
+	Quadric q = quadrics[v0];
+	q.Add(quadrics[v1]);
+
+	const Vector3f &p0 = vertices[v0], &p1 = vertices[v1];
+	collapse.keptVertex = onBoundary[v1] ? v1 : v0;
+	collapse.removedVertex = onBoundary[v1] ? v0 : v1;
+
+	if (onBoundary[v0] || onBoundary[v1])
+	{
+		collapse.position = vertices[collapse.keptVertex];
+		collapse.cost = q.Evaluate(collapse.position);
+	}
+	else
+	{
+		// the optimum, unless it is ill-conditioned or far off the edge, otherwise the best of the end and mid points
+		Vector3f midPoint = (p0 + p1) * 0.5f, optimum;
+		Vector3f candidates[3] = { p0, p1, midPoint };
+
+		collapse.cost = DBL_MAX;
+		if (q.Minimise(optimum) && dot(optimum - midPoint, optimum - midPoint) <= dot(p1 - p0, p1 - p0))
+		{
+			collapse.position = optimum;
+			collapse.cost = q.Evaluate(optimum);
+		}
+		else for (int i = 0; i < 3; i++)
+		{
+			double cost = q.Evaluate(candidates[i]);
+			if (cost < collapse.cost) { collapse.cost = cost; collapse.position = candidates[i]; }
+		}
+	}
+
+	collapse.cost = MAX(collapse.cost, 0.0);
+	if (collapse.cost > maxCost) return false;
+
+	// the two vertices may only share the neighbours opposite the edge, otherwise the collapse pinches the surface
+	int noSharedNeighbours = 0;
+	for (int i = 0, j = 0; i < noNeighbours0 && j < noNeighbours1; )
+	{
+		if (neighbours0[i] < neighbours1[j]) i++;
+		else if (neighbours1[j] < neighbours0[i]) j++;
+		else { noSharedNeighbours++; i++; j++; }
+	}
+	if (noSharedNeighbours != 2) return false;
+
+	// and the merged vertex needs at least three neighbours, so that closed surfaces do not fold flat
+	if (noNeighbours0 + noNeighbours1 - 4 < 3) return false;
+
+	return keepsOrientation(v0, v1, collapse.position, vertices, faces, faceStart, faceIds) &&
+		keepsOrientation(v1, v0, collapse.position, vertices, faces, faceStart, faceIds);
+}
+
+static void removeUnusedVertices(ITMIndexedMesh *mesh)
+{
+	std::vector<int> newIds(mesh->vertices.size(), -1);
+	for (size_t i = 0; i < mesh->faces.size(); i++)
+		for (int j = 0; j < 3; j++) newIds[mesh->faces[i][j]] = 0;
+
+	bool hasNormals = mesh->normals.size() == mesh->vertices.size(), hasColours = mesh->colours.size() == mesh->vertices.size();
+
+	int noVertices = 0;
+	for (size_t v = 0; v < newIds.size(); v++)
+	{
+		if (newIds[v] < 0) continue;
+
+		newIds[v] = noVertices;
+		mesh->vertices[noVertices] = mesh->vertices[v];
+		if (hasNormals) mesh->normals[noVertices] = mesh->normals[v];
+		if (hasColours) mesh->colours[noVertices] = mesh->colours[v];
+		noVertices++;
+	}
+
+	mesh->vertices.resize(noVertices);
+	if (hasNormals) mesh->normals.resize(noVertices);
+	if (hasColours) mesh->colours.resize(noVertices);
+
+	for (size_t i = 0; i < mesh->faces.size(); i++)
+		mesh->faces[i] = Vector3i(newIds[mesh->faces[i].x], newIds[mesh->faces[i].y], newIds[mesh->faces[i].z]);
+}
+
+void ITMMeshDecimationEngine_CPU::Decimate(ITMIndexedMesh *mesh, size_t targetNoFaces, float maxError) const
+{
+	std::vector<Vector3f> &vertices = mesh->vertices;
+	std::vector<Vector3i> &faces = mesh->faces;
+	int noVertices = (int)vertices.size();
+
+	// welding turns the zero-area triangles of marching cubes into faces with repeated vertices
+	removeDegenerateFaces(faces);
+	if (faces.empty()) { mesh->Clear(); return; }
+
+	double maxCost = maxError > 0.0f ? (double)maxError * maxError : DBL_MAX;
+
+	std::vector<int> faceStart, faceIds;
+	buildVertexFaces(faces, noVertices, faceStart, faceIds);
+
+	// each vertex starts with the planes of the faces around it
+	std::vector<Quadric> quadrics(noVertices);
+#ifdef WITH_OPENMP
+	#pragma omp parallel for
+#endif
+	for (int v = 0; v < noVertices; v++)
+	{
+		for (int i = faceStart[v]; i < faceStart[v + 1]; i++)
+		{
+			const Vector3i &f = faces[faceIds[i]];
+			Vector3f normal = cross(vertices[f.y] - vertices[f.x], vertices[f.z] - vertices[f.x]);
+			float norm = sqrt(dot(normal, normal));
+			if (norm == 0.0f) continue;
+
+			normal /= norm;
+			quadrics[v].AddPlane(normal, -dot(normal, vertices[f.x]));
+		}
+	}
+
+	// the neighbours of each vertex, in slots of two entries per face around it
+	std::vector<int> neighbours(faceIds.size() * 2), noSharedFaces(faceIds.size() * 2), noNeighbours(noVertices);
+
+	// vertices on boundary or non-manifold edges, which keep their position
+	std::vector<char> onBoundary(noVertices, 0);
+#ifdef WITH_OPENMP
+	#pragma omp parallel for
+#endif
+	for (int v = 0; v < noVertices; v++)
+	{
+		int slot = faceStart[v] * 2;
+		noNeighbours[v] = collectNeighbours(neighbours.data() + slot, noSharedFaces.data() + slot, v, faces, faceStart, faceIds);
+		for (int i = 0; i < noNeighbours[v]; i++) if (noSharedFaces[slot + i] != 2) onBoundary[v] = 1;
+	}
+
+	// the allowed collapses of the edges to neighbours with higher ids, for each vertex, only updated where the last round changed the mesh
+	std::vector<std::vector<EdgeCollapse> > vertexCollapses(noVertices);
+	std::vector<char> needsUpdate(noVertices, 1), isMarked(noVertices);
+	std::vector<CollapseCandidate> candidates;
+	std::vector<int> remap(noVertices);
+	for (int v = 0; v < noVertices; v++) remap[v] = v;
+
+	// each round collapses a set of edges whose neighbourhoods do not overlap, picked in order of increasing error
+	while (targetNoFaces == 0 || faces.size() > targetNoFaces)
+	{
+#ifdef WITH_OPENMP
+		#pragma omp parallel for schedule(dynamic, 256)
+#endif
+		for (int v = 0; v < noVertices; v++)
+		{
+			if (!needsUpdate[v]) continue;
+
+			vertexCollapses[v].clear();
+
+			int slot0 = faceStart[v] * 2;
+			for (int i = 0; i < noNeighbours[v]; i++)
+			{
+				// edges on one face are on the boundary, edges on more are not manifold
+				int n = neighbours[slot0 + i];
+				if (n < v || noSharedFaces[slot0 + i] != 2) continue;
+
+				EdgeCollapse collapse;
+				if (evaluateCollapse(collapse, v, n, neighbours.data() + slot0, noNeighbours[v], neighbours.data() + faceStart[n] * 2, noNeighbours[n], maxCost,
+					vertices, faces, faceStart, faceIds, onBoundary, quadrics))
+					vertexCollapses[v].push_back(collapse);
+			}
+		}
+
+		candidates.clear();
+		for (int v = 0; v < noVertices; v++)
+		{
+			for (size_t i = 0; i < vertexCollapses[v].size(); i++)
+			{
+				CollapseCandidate candidate;
+				candidate.cost = vertexCollapses[v][i].cost; candidate.vertex = v; candidate.collapseId = (int)i;
+				candidates.push_back(candidate);
+			}
+		}
+		if (candidates.empty()) break;
+
+		std::sort(candidates.begin(), candidates.end());
+
+		// only the cheaper half competes in this round, the others wait for the errors to be updated
+		size_t noConsidered = (candidates.size() + 1) / 2;
+		size_t noFaces = faces.size();
+		isMarked.assign(noVertices, 0);
+
+		for (size_t i = 0; i < noConsidered; i++)
+		{
+			if (targetNoFaces > 0 && noFaces <= targetNoFaces) break;
+
+			const EdgeCollapse &collapse = vertexCollapses[candidates[i].vertex][candidates[i].collapseId];
+			if (isMarked[collapse.keptVertex] || isMarked[collapse.removedVertex]) continue;
+
+			for (int j = 0; j < 2; j++)
+			{
+				int v = j == 0 ? collapse.keptVertex : collapse.removedVertex;
+				for (int k = faceStart[v]; k < faceStart[v + 1]; k++)
+				{
+					const Vector3i &f = faces[faceIds[k]];
+					isMarked[f.x] = isMarked[f.y] = isMarked[f.z] = 1;
+				}
+			}
+
+			vertices[collapse.keptVertex] = collapse.position;
+			quadrics[collapse.keptVertex].Add(quadrics[collapse.removedVertex]);
+			remap[collapse.removedVertex] = collapse.keptVertex;
+			noFaces -= 2;
+		}
+
+		// the two faces on each collapsed edge degenerate and are dropped
+		for (size_t i = 0; i < faces.size(); i++)
+			faces[i] = Vector3i(remap[faces[i].x], remap[faces[i].y], remap[faces[i].z]);
+		removeDegenerateFaces(faces);
+
+		buildVertexFaces(faces, noVertices, faceStart, faceIds);
+
+		// a collapse changes the neighbourhoods of the marked vertices only, so the edges of all others keep their costs
+#ifdef WITH_OPENMP
+		#pragma omp parallel for
+#endif
+		for (int v = 0; v < noVertices; v++)
+		{
+			int slot = faceStart[v] * 2;
+			noNeighbours[v] = collectNeighbours(neighbours.data() + slot, noSharedFaces.data() + slot, v, faces, faceStart, faceIds);
+
+			needsUpdate[v] = isMarked[v];
+			for (int i = 0; i < noNeighbours[v] && !needsUpdate[v]; i++) if (isMarked[neighbours[slot + i]]) needsUpdate[v] = 1;
+		}
+	}
+
+	removeUnusedVertices(mesh);
+	if (!mesh->normals.empty()) mesh->ComputeNormalsFromFaces();
+}
@@ -0,0 +1,34 @@
+// Copyright 2014-2017 Oxford University Innovation Limited and the authors of InfiniTAM
+
+#pragma once
+
+#include "../../../Objects/Meshing/ITMIndexedMesh.h"
+
+namespace ITMLib
+{
+	/** \brief
+	    Simplifies indexed meshes by collapsing edges in order of
+	    increasing quadric error (Garland and Heckbert). Collapses
+	    are applied in rounds of independent edges, each round
+	    evaluated in parallel, so the result does not depend on the
+	    number of threads. Boundary vertices are never moved, so
+	    meshes of adjacent regions still fit together.
+
+	    Indexed meshes always live in host memory, so this engine is
+	    used with all devices.
+	*/
+	class ITMMeshDecimationEngine_CPU
+	{
+	public:
+		/** Collapses edges until the mesh has at most targetNoFaces
+		    faces, or until no edge can be collapsed without moving
+		    the surface further than maxError metres from the planes
+		    of the original faces around it. A value of 0 disables
+		    either criterion. Normals are recomputed if present.
+		*/
+		void Decimate(ITMIndexedMesh *mesh, size_t targetNoFaces, float maxError) const;
+
+		ITMMeshDecimationEngine_CPU(void) { }
+		~ITMMeshDecimationEngine_CPU(void) { }
+	};
+}
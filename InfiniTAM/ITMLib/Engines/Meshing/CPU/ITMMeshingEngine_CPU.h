@@ -5,21 +5,59 @@
 #include "../Interface/ITMMeshingEngine.h"
 #include "../../../Objects/Scene/ITMPlainVoxelArray.h"
 
+#include <vector>
+
 namespace ITMLib
 {
 	template<class TVoxel, class TIndex>
 	class ITMMeshingEngine_CPU : public ITMMeshingEngine < TVoxel, TIndex >
 	{
 		void MeshScene(ITMMesh *mesh, const ITMScene<TVoxel, TIndex> *scene) { }
+		void MeshScene(ITMIndexedMesh *mesh, const ITMScene<TVoxel, TIndex> *scene) { }
+		void MeshScene(ITMMesh *mesh, const ITMScene<TVoxel, TIndex> *scene, const ITMMeshRegion &region, int voxelStride = 1) { }
+		void MeshScene(ITMIndexedMesh *mesh, const ITMScene<TVoxel, TIndex> *scene, const ITMMeshRegion &region, int voxelStride = 1) { }
+		void MeshScene(ITMMeshWriter *writer, const ITMScene<TVoxel, TIndex> *scene) { }
+		void FindOccupiedTiles(std::vector<Vector3i> &tiles, const ITMScene<TVoxel, TIndex> *scene, int tileSize) { }
+		ITMScene<TVoxel, TIndex>* MakeSceneSnapshot(const ITMScene<TVoxel, TIndex> *scene) { return NULL; }
 	};
 
 	template<class TVoxel>
 	class ITMMeshingEngine_CPU<TVoxel, ITMVoxelBlockHash> : public ITMMeshingEngine < TVoxel, ITMVoxelBlockHash >
 	{
+	private:
+		/// Number of hash entries meshed as one unit of work
+		static const int noEntriesPerChunk = 4096;
+		/// Number of listed blocks meshed as one unit of work
+		static const int noBlocksPerChunk = 64;
+		/// Number of listed blocks whose triangles are held in memory at a time when streaming to a writer
+		static const int noBlocksPerBatch = 64 * noBlocksPerChunk;
+
+		/// Triangles of each hash entry from the last call to MeshScene, reused for entries that have not changed since
+		std::vector<std::vector<ITMMesh::Triangle> > entryTriangles;
+		/// Scene, modification count and number of stamp resets at which entryTriangles was last brought up to date
+		const ITMScene<TVoxel, ITMVoxelBlockHash> *meshedScene;
+		uint meshedModificationCount, meshedNoModificationResets;
+
+		/// Mesh the blocks of the given hash entries, which are expected in ascending order, with cells of voxelStride voxels
+		void MeshEntries(ITMMesh *mesh, const ITMScene<TVoxel, ITMVoxelBlockHash> *scene, const std::vector<int> &entryIds, int voxelStride);
+		void MeshEntries(ITMIndexedMesh *mesh, const ITMScene<TVoxel, ITMVoxelBlockHash> *scene, const std::vector<int> &entryIds, int voxelStride);
+
 	public:
+		/** Meshes the scene incrementally: only the blocks modified
+		    since the previous call, and the neighbouring blocks whose
+		    cells sample them, are meshed again. The output is the same
+		    as meshing the whole scene.
+		*/
 		void MeshScene(ITMMesh *mesh, const ITMScene<TVoxel, ITMVoxelBlockHash> *scene);
+		void MeshScene(ITMIndexedMesh *mesh, const ITMScene<TVoxel, ITMVoxelBlockHash> *scene);
+
+		void MeshScene(ITMMesh *mesh, const ITMScene<TVoxel, ITMVoxelBlockHash> *scene, const ITMMeshRegion &region, int voxelStride = 1);
+		void MeshScene(ITMIndexedMesh *mesh, const ITMScene<TVoxel, ITMVoxelBlockHash> *scene, const ITMMeshRegion &region, int voxelStride = 1);
+		void MeshScene(ITMMeshWriter *writer, const ITMScene<TVoxel, ITMVoxelBlockHash> *scene);
+		void FindOccupiedTiles(std::vector<Vector3i> &tiles, const ITMScene<TVoxel, ITMVoxelBlockHash> *scene, int tileSize);
+		ITMScene<TVoxel, ITMVoxelBlockHash>* MakeSceneSnapshot(const ITMScene<TVoxel, ITMVoxelBlockHash> *scene);
 
-		ITMMeshingEngine_CPU(void) { }
+		ITMMeshingEngine_CPU(void) : meshedScene(NULL), meshedModificationCount(0), meshedNoModificationResets(0) { }
 		~ITMMeshingEngine_CPU(void) { }
 	};
 }
@@ -3,46 +3,494 @@
 #include "ITMMeshingEngine_CPU.h"
 #include "../Shared/ITMMeshingEngine_Shared.h"
 
+#include <algorithm>
+#include <vector>
+
 using namespace ITMLib;
 
+/// Index of the hash entry of an allocated block, or -1
+static inline int findAllocatedEntry(const ITMHashEntry *hashTable, const Vector3i &blockPos)
+{
+	int hashIdx = hashIndex(blockPos);
+
+	while (true)
+	{
+		const ITMHashEntry &hashEntry = hashTable[hashIdx];
+
+		if (IS_EQUAL3(hashEntry.pos, blockPos) && hashEntry.ptr >= 0) return hashIdx;
+		if (hashEntry.offset < 1) return -1;
+		hashIdx = SDF_BUCKET_NUM + hashEntry.offset - 1;
+	}
+}
+
+/// Appends the triangles of the cells of an allocated block, for cells of stride voxels
 template<class TVoxel>
-void ITMMeshingEngine_CPU<TVoxel, ITMVoxelBlockHash>::MeshScene(ITMMesh *mesh, const ITMScene<TVoxel, ITMVoxelBlockHash> *scene)
+static inline void meshBlock(std::vector<ITMMesh::Triangle> &triangles, const ITMHashEntry &hashEntry, const TVoxel *localVBA,
+	const ITMHashEntry *hashTable, float factor, int stride)
 {
+	Vector3i globalPos = hashEntry.pos.toInt() * SDF_BLOCK_SIZE;
+
+	for (int z = 0; z < SDF_BLOCK_SIZE; z += stride) for (int y = 0; y < SDF_BLOCK_SIZE; y += stride) for (int x = 0; x < SDF_BLOCK_SIZE; x += stride)
+	{
+		Vector3f vertList[12];
+		int cubeIndex = buildVertList(vertList, globalPos, Vector3i(x, y, z), localVBA, hashTable, stride);
+
+		if (cubeIndex < 0) continue;
+
+		for (int i = 0; triangleTable[cubeIndex][i] != -1; i += 3)
+		{
+			ITMMesh::Triangle triangle;
+			triangle.p0 = vertList[triangleTable[cubeIndex][i]] * factor;
+			triangle.p1 = vertList[triangleTable[cubeIndex][i + 1]] * factor;
+			triangle.p2 = vertList[triangleTable[cubeIndex][i + 2]] * factor;
+			triangles.push_back(triangle);
+		}
+	}
+}
+
+/// Concatenates the triangle lists into the mesh, as far as it can hold them
+static void copyTriangles(ITMMesh *mesh, const std::vector<std::vector<ITMMesh::Triangle> > &triangleLists)
+{
+	uint noTriangles = 0;
+	for (size_t listId = 0; listId < triangleLists.size(); listId++) noTriangles += (uint)triangleLists[listId].size();
+
+	uint noStoredTriangles = mesh->ReserveTriangles(noTriangles);
 	ITMMesh::Triangle *triangles = mesh->triangles->GetData(MEMORYDEVICE_CPU);
+
+	uint offset = 0;
+	for (size_t listId = 0; listId < triangleLists.size() && offset < noStoredTriangles; listId++)
+	{
+		const std::vector<ITMMesh::Triangle> &triangles_list = triangleLists[listId];
+		uint noCopied = MIN((uint)triangles_list.size(), noStoredTriangles - offset);
+
+		std::copy(triangles_list.begin(), triangles_list.begin() + noCopied, triangles + offset);
+		offset += noCopied;
+	}
+
+	mesh->SetNoProducedTriangles(noTriangles);
+}
+
+/// Ascending indices of the hash entries of the allocated blocks that overlap the region
+static void findEntriesInRegion(std::vector<int> &entryIds, const ITMHashEntry *hashTable, int noTotalEntries, const ITMMeshRegion &region,
+	float blockSize)
+{
+	entryIds.clear();
+
+	Vector3i blockMin, blockMax;
+	region.GetBlockRange(blockSize, blockMin, blockMax);
+	if (blockMin.x > blockMax.x || blockMin.y > blockMax.y || blockMin.z > blockMax.z) return;
+
+	long long noRegionBlocks = (long long)(blockMax.x - blockMin.x + 1) * (blockMax.y - blockMin.y + 1) * (blockMax.z - blockMin.z + 1);
+
+	if (noRegionBlocks < noTotalEntries)
+	{
+		// look up every block of the region in the hash table
+		for (int z = blockMin.z; z <= blockMax.z; z++) for (int y = blockMin.y; y <= blockMax.y; y++) for (int x = blockMin.x; x <= blockMax.x; x++)
+		{
+			if (!region.OverlapsBlock(Vector3i(x, y, z), blockSize)) continue;
+
+			int entryId = findAllocatedEntry(hashTable, Vector3i(x, y, z));
+			if (entryId >= 0) entryIds.push_back(entryId);
+		}
+
+		std::sort(entryIds.begin(), entryIds.end());
+	}
+	else
+	{
+		// the region is larger than the hash table, so test the entries instead
+		for (int entryId = 0; entryId < noTotalEntries; entryId++)
+		{
+			const ITMHashEntry &hashEntry = hashTable[entryId];
+			if (hashEntry.ptr >= 0 && region.OverlapsBlock(hashEntry.pos.toInt(), blockSize)) entryIds.push_back(entryId);
+		}
+	}
+}
+
+template<class TVoxel>
+void ITMMeshingEngine_CPU<TVoxel, ITMVoxelBlockHash>::MeshScene(ITMMesh *mesh, const ITMScene<TVoxel, ITMVoxelBlockHash> *scene)
+{
 	const TVoxel *localVBA = scene->localVBA.GetVoxelBlocks();
 	const ITMHashEntry *hashTable = scene->index.GetEntries();
+	const uint *modificationStamps = scene->index.GetModificationStamps();
 
-	int noTriangles = 0, noMaxTriangles = mesh->noMaxTriangles, noTotalEntries = scene->index.noTotalEntries;
+	int noTotalEntries = scene->index.noTotalEntries;
 	float factor = scene->sceneParams->voxelSize;
+	uint modificationCount = scene->index.GetModificationCount();
 
-	mesh->triangles->Clear();
+	// everything is meshed on the first call, for a different scene, and after the whole hash table was reset or replaced
+	bool meshAllEntries = meshedScene != scene || (int)entryTriangles.size() != noTotalEntries ||
+		scene->index.GetNoModificationResets() != meshedNoModificationResets ||
+		modificationCount < meshedModificationCount || scene->index.GetAllModifiedStamp() > meshedModificationCount;
 
-	for (int entryId = 0; entryId < noTotalEntries; entryId++)
+	std::vector<uchar> entriesToMesh(noTotalEntries, meshAllEntries ? 1 : 0);
+
+	if (meshAllEntries) entryTriangles.assign(noTotalEntries, std::vector<ITMMesh::Triangle>());
+	else
+	{
+		// the cells of a block also sample the blocks at +x, +y and +z, so a modified block invalidates the seven blocks
+		// below it as well
+		for (int entryId = 0; entryId < noTotalEntries; entryId++)
+		{
+			if (modificationStamps[entryId] <= meshedModificationCount) continue;
+
+			entriesToMesh[entryId] = 1;
+
+			Vector3i blockPos = hashTable[entryId].pos.toInt();
+			for (int z = 0; z < 2; z++) for (int y = 0; y < 2; y++) for (int x = 0; x < 2; x++)
+			{
+				if (x == 0 && y == 0 && z == 0) continue;
+
+				int neighbourId = findAllocatedEntry(hashTable, blockPos - Vector3i(x, y, z));
+				if (neighbourId >= 0) entriesToMesh[neighbourId] = 1;
+			}
+		}
+	}
+
+	// entries are meshed into their own lists in fixed ranges, and the lists are concatenated in entry order afterwards,
+	// so the output is the same for any number of threads and whether or not the lists were cached
+	int noChunks = (noTotalEntries + noEntriesPerChunk - 1) / noEntriesPerChunk;
+
+#ifdef WITH_OPENMP
+	#pragma omp parallel for schedule(dynamic)
+#endif
+	for (int chunkId = 0; chunkId < noChunks; chunkId++)
+	{
+		int entryEnd = MIN((chunkId + 1) * noEntriesPerChunk, noTotalEntries);
+
+		for (int entryId = chunkId * noEntriesPerChunk; entryId < entryEnd; entryId++)
+		{
+			if (!entriesToMesh[entryId]) continue;
+
+			std::vector<ITMMesh::Triangle> &triangles_entry = entryTriangles[entryId];
+			const ITMHashEntry &currentHashEntry = hashTable[entryId];
+
+			if (currentHashEntry.ptr < 0)
+			{
+				std::vector<ITMMesh::Triangle>().swap(triangles_entry);
+				continue;
+			}
+
+			triangles_entry.clear();
+			meshBlock(triangles_entry, currentHashEntry, localVBA, hashTable, factor, 1);
+		}
+	}
+
+	meshedScene = scene;
+	meshedModificationCount = modificationCount;
+	meshedNoModificationResets = scene->index.GetNoModificationResets();
+
+	copyTriangles(mesh, entryTriangles);
+}
+
+template<class TVoxel>
+void ITMMeshingEngine_CPU<TVoxel, ITMVoxelBlockHash>::MeshEntries(ITMMesh *mesh, const ITMScene<TVoxel, ITMVoxelBlockHash> *scene,
+	const std::vector<int> &entryIds, int voxelStride)
+{
+	const TVoxel *localVBA = scene->localVBA.GetVoxelBlocks();
+	const ITMHashEntry *hashTable = scene->index.GetEntries();
+
+	float factor = scene->sceneParams->voxelSize;
+
+	int noEntries = (int)entryIds.size();
+	int noChunks = (noEntries + noBlocksPerChunk - 1) / noBlocksPerChunk;
+	std::vector<std::vector<ITMMesh::Triangle> > chunkTriangles(noChunks);
+
+#ifdef WITH_OPENMP
+	#pragma omp parallel for schedule(dynamic)
+#endif
+	for (int chunkId = 0; chunkId < noChunks; chunkId++)
+	{
+		int listEnd = MIN((chunkId + 1) * noBlocksPerChunk, noEntries);
+
+		for (int listId = chunkId * noBlocksPerChunk; listId < listEnd; listId++)
+		{
+			const ITMHashEntry &currentHashEntry = hashTable[entryIds[listId]];
+			if (currentHashEntry.ptr >= 0) meshBlock(chunkTriangles[chunkId], currentHashEntry, localVBA, hashTable, factor, voxelStride);
+		}
+	}
+
+	copyTriangles(mesh, chunkTriangles);
+}
+
+template<class TVoxel>
+void ITMMeshingEngine_CPU<TVoxel, ITMVoxelBlockHash>::MeshScene(ITMMesh *mesh, const ITMScene<TVoxel, ITMVoxelBlockHash> *scene,
+	const ITMMeshRegion &region, int voxelStride)
+{
+	std::vector<int> entryIds;
+	findEntriesInRegion(entryIds, scene->index.GetEntries(), scene->index.noTotalEntries, region, scene->sceneParams->voxelSize * SDF_BLOCK_SIZE);
+
+	MeshEntries(mesh, scene, entryIds, voxelStride);
+}
+
+template<class TVoxel>
+void ITMMeshingEngine_CPU<TVoxel, ITMVoxelBlockHash>::MeshScene(ITMMeshWriter *writer, const ITMScene<TVoxel, ITMVoxelBlockHash> *scene)
+{
+	const TVoxel *localVBA = scene->localVBA.GetVoxelBlocks();
+	const ITMHashEntry *hashTable = scene->index.GetEntries();
+
+	int noTotalEntries = scene->index.noTotalEntries;
+	float factor = scene->sceneParams->voxelSize;
+
+	std::vector<int> entryIds;
+	for (int entryId = 0; entryId < noTotalEntries; entryId++) if (hashTable[entryId].ptr >= 0) entryIds.push_back(entryId);
+
+	// the blocks are meshed in batches in entry order, as in MeshEntries, and each batch is written out before the next
+	// one is meshed, so that the triangles of one batch only are held in memory
+	int noEntries = (int)entryIds.size();
+	std::vector<std::vector<ITMMesh::Triangle> > chunkTriangles(noBlocksPerBatch / noBlocksPerChunk);
+
+	for (int batchBegin = 0; batchBegin < noEntries; batchBegin += noBlocksPerBatch)
 	{
-		Vector3i globalPos;
-		const ITMHashEntry &currentHashEntry = hashTable[entryId];
+		int batchEnd = MIN(batchBegin + noBlocksPerBatch, noEntries);
+		int noChunks = (batchEnd - batchBegin + noBlocksPerChunk - 1) / noBlocksPerChunk;
+
+#ifdef WITH_OPENMP
+		#pragma omp parallel for schedule(dynamic)
+#endif
+		for (int chunkId = 0; chunkId < noChunks; chunkId++)
+		{
+			std::vector<ITMMesh::Triangle> &triangles_chunk = chunkTriangles[chunkId];
+			int listEnd = MIN(batchBegin + (chunkId + 1) * noBlocksPerChunk, batchEnd);
+
+			triangles_chunk.clear();
+			for (int listId = batchBegin + chunkId * noBlocksPerChunk; listId < listEnd; listId++)
+				meshBlock(triangles_chunk, hashTable[entryIds[listId]], localVBA, hashTable, factor, 1);
+		}
+
+		for (int chunkId = 0; chunkId < noChunks; chunkId++)
+			if (!chunkTriangles[chunkId].empty()) writer->WriteTriangles(&chunkTriangles[chunkId][0], chunkTriangles[chunkId].size());
+	}
+}
+
+/// Vertex on a cell edge, identified by the voxel at the edge's lower end and the edge's axis
+struct ITMEdgeVertex
+{
+	unsigned long long key; Vector3f p;
+	bool operator<(const ITMEdgeVertex &other) const { return key < other.key; }
+};
+
+static inline bool sameEdge(const ITMEdgeVertex &a, const ITMEdgeVertex &b) { return a.key == b.key; }
+
+static inline unsigned long long edgeKey(const Vector3i &voxelPos, int axis)
+{
+	// voxel coordinates of blocks addressable by the hash lie in [-2^18, 2^18)
+	const int offset = 1 << 18;
+	return ((unsigned long long)(voxelPos.z + offset) << 40) | ((unsigned long long)(voxelPos.y + offset) << 21) |
+		((unsigned long long)(voxelPos.x + offset) << 2) | (unsigned long long)axis;
+}
+
+template<class TVoxel>
+void ITMMeshingEngine_CPU<TVoxel, ITMVoxelBlockHash>::MeshScene(ITMIndexedMesh *mesh, const ITMScene<TVoxel, ITMVoxelBlockHash> *scene)
+{
+	const ITMHashEntry *hashTable = scene->index.GetEntries();
+	int noTotalEntries = scene->index.noTotalEntries;
+
+	std::vector<int> entryIds;
+	for (int entryId = 0; entryId < noTotalEntries; entryId++) if (hashTable[entryId].ptr >= 0) entryIds.push_back(entryId);
+
+	MeshEntries(mesh, scene, entryIds, 1);
+}
+
+template<class TVoxel>
+void ITMMeshingEngine_CPU<TVoxel, ITMVoxelBlockHash>::MeshScene(ITMIndexedMesh *mesh, const ITMScene<TVoxel, ITMVoxelBlockHash> *scene,
+	const ITMMeshRegion &region, int voxelStride)
+{
+	std::vector<int> entryIds;
+	findEntriesInRegion(entryIds, scene->index.GetEntries(), scene->index.noTotalEntries, region, scene->sceneParams->voxelSize * SDF_BLOCK_SIZE);
+
+	MeshEntries(mesh, scene, entryIds, voxelStride);
+}
+
+template<class TVoxel>
+void ITMMeshingEngine_CPU<TVoxel, ITMVoxelBlockHash>::MeshEntries(ITMIndexedMesh *mesh, const ITMScene<TVoxel, ITMVoxelBlockHash> *scene,
+	const std::vector<int> &entryIds, int voxelStride)
+{
+	const TVoxel *localVBA = scene->localVBA.GetVoxelBlocks();
+	const ITMHashEntry *hashTable = scene->index.GetEntries();
+
+	float factor = scene->sceneParams->voxelSize;
+
+	mesh->Clear();
 
-		if (currentHashEntry.ptr < 0) continue;
+	// as for the triangle soup, but each chunk records the edge keys of its triangle corners and its distinct edge
+	// vertices; the vertices of all chunks are then merged in key order, which makes the result thread independent
+	int noEntries = (int)entryIds.size();
+	int noChunks = (noEntries + noBlocksPerChunk - 1) / noBlocksPerChunk;
+	std::vector<std::vector<unsigned long long> > chunkCorners(noChunks);
+	std::vector<std::vector<ITMEdgeVertex> > chunkVertices(noChunks);
 
-		globalPos = currentHashEntry.pos.toInt() * SDF_BLOCK_SIZE;
+#ifdef WITH_OPENMP
+	#pragma omp parallel for schedule(dynamic)
+#endif
+	for (int chunkId = 0; chunkId < noChunks; chunkId++)
+	{
+		std::vector<unsigned long long> &corners_chunk = chunkCorners[chunkId];
+		std::vector<ITMEdgeVertex> &vertices_chunk = chunkVertices[chunkId];
+		int listEnd = MIN((chunkId + 1) * noBlocksPerChunk, noEntries);
 
-		for (int z = 0; z < SDF_BLOCK_SIZE; z++) for (int y = 0; y < SDF_BLOCK_SIZE; y++) for (int x = 0; x < SDF_BLOCK_SIZE; x++)
+		for (int listId = chunkId * noBlocksPerChunk; listId < listEnd; listId++)
 		{
-			Vector3f vertList[12];
-			int cubeIndex = buildVertList(vertList, globalPos, Vector3i(x, y, z), localVBA, hashTable);
-			
-			if (cubeIndex < 0) continue;
+			Vector3i globalPos;
+			const ITMHashEntry &currentHashEntry = hashTable[entryIds[listId]];
 
-			for (int i = 0; triangleTable[cubeIndex][i] != -1; i += 3)
+			if (currentHashEntry.ptr < 0) continue;
+
+			globalPos = currentHashEntry.pos.toInt() * SDF_BLOCK_SIZE;
+
+			for (int z = 0; z < SDF_BLOCK_SIZE; z += voxelStride) for (int y = 0; y < SDF_BLOCK_SIZE; y += voxelStride) for (int x = 0; x < SDF_BLOCK_SIZE; x += voxelStride)
 			{
-				triangles[noTriangles].p0 = vertList[triangleTable[cubeIndex][i]] * factor;
-				triangles[noTriangles].p1 = vertList[triangleTable[cubeIndex][i + 1]] * factor;
-				triangles[noTriangles].p2 = vertList[triangleTable[cubeIndex][i + 2]] * factor;
+				Vector3f vertList[12];
+				int cubeIndex = buildVertList(vertList, globalPos, Vector3i(x, y, z), localVBA, hashTable, voxelStride);
+
+				if (cubeIndex < 0) continue;
 
-				if (noTriangles < noMaxTriangles - 1) noTriangles++;
+				for (int i = 0; triangleTable[cubeIndex][i] != -1; i++)
+				{
+					int edgeId = triangleTable[cubeIndex][i];
+					const int *origin = edgeOrigin[edgeId];
+
+					ITMEdgeVertex vertex;
+					vertex.key = edgeKey(globalPos + Vector3i(x + origin[0] * voxelStride, y + origin[1] * voxelStride, z + origin[2] * voxelStride), origin[3]);
+					vertex.p = vertList[edgeId];
+
+					corners_chunk.push_back(vertex.key);
+					vertices_chunk.push_back(vertex);
+				}
 			}
 		}
+
+		std::sort(vertices_chunk.begin(), vertices_chunk.end());
+		vertices_chunk.erase(std::unique(vertices_chunk.begin(), vertices_chunk.end(), sameEdge), vertices_chunk.end());
 	}
 
-	mesh->noTotalTriangles = noTriangles;
-}
\ No newline at end of file
+	// merge the edge vertices, chunks bordering each other share some of them
+	std::vector<ITMEdgeVertex> edgeVertices;
+	for (int chunkId = 0; chunkId < noChunks; chunkId++)
+	{
+		edgeVertices.insert(edgeVertices.end(), chunkVertices[chunkId].begin(), chunkVertices[chunkId].end());
+		std::vector<ITMEdgeVertex>().swap(chunkVertices[chunkId]);
+	}
+
+	std::sort(edgeVertices.begin(), edgeVertices.end());
+	edgeVertices.erase(std::unique(edgeVertices.begin(), edgeVertices.end(), sameEdge), edgeVertices.end());
+
+	int noVertices = (int)edgeVertices.size();
+	mesh->vertices.resize(noVertices);
+	if (mesh->withNormals) mesh->normals.resize(noVertices);
+	if (mesh->withColours && TVoxel::hasColorInformation) mesh->colours.resize(noVertices);
+
+#ifdef WITH_OPENMP
+	#pragma omp parallel for
+#endif
+	for (int vertexId = 0; vertexId < noVertices; vertexId++)
+	{
+		const Vector3f &point = edgeVertices[vertexId].p;
+		mesh->vertices[vertexId] = point * factor;
+
+		if (mesh->withNormals)
+		{
+			Vector3f normal = computeSingleNormalFromSDF(localVBA, hashTable, point);
+			float norm = sqrt(dot(normal, normal));
+			mesh->normals[vertexId] = norm > 0.0f ? normal / norm : normal;
+		}
+
+		if (mesh->withColours && TVoxel::hasColorInformation)
+		{
+			Vector4f colour = VoxelColorReader<TVoxel::hasColorInformation, TVoxel, ITMVoxelBlockHash>::interpolate(localVBA, hashTable, point);
+			mesh->colours[vertexId] = TO_UCHAR3(TO_VECTOR3(colour) * 255.0f);
+		}
+	}
+
+	// replace the corners' edge keys by vertex indices
+	std::vector<int> chunkFaceOffsets(noChunks + 1, 0);
+	for (int chunkId = 0; chunkId < noChunks; chunkId++)
+		chunkFaceOffsets[chunkId + 1] = chunkFaceOffsets[chunkId] + (int)chunkCorners[chunkId].size() / 3;
+
+	mesh->faces.resize(chunkFaceOffsets[noChunks]);
+
+#ifdef WITH_OPENMP
+	#pragma omp parallel for schedule(dynamic)
+#endif
+	for (int chunkId = 0; chunkId < noChunks; chunkId++)
+	{
+		const std::vector<unsigned long long> &corners_chunk = chunkCorners[chunkId];
+		if (corners_chunk.empty()) continue;
+
+		int *faceIndices = &mesh->faces[chunkFaceOffsets[chunkId]].x;
+
+		for (size_t cornerId = 0; cornerId < corners_chunk.size(); cornerId++)
+		{
+			ITMEdgeVertex vertex; vertex.key = corners_chunk[cornerId];
+			faceIndices[cornerId] = (int)(std::lower_bound(edgeVertices.begin(), edgeVertices.end(), vertex) - edgeVertices.begin());
+		}
+	}
+}
+
+/// Orders tile coordinates by z, then y, then x
+static inline bool tileLess(const Vector3i &a, const Vector3i &b)
+{
+	if (a.z != b.z) return a.z < b.z;
+	if (a.y != b.y) return a.y < b.y;
+	return a.x < b.x;
+}
+
+static inline bool sameTile(const Vector3i &a, const Vector3i &b) { return a == b; }
+
+/// Floor division, also for negative block coordinates
+static inline int floorDiv(int a, int b) { return a >= 0 ? a / b : -((-a + b - 1) / b); }
+
+template<class TVoxel>
+void ITMMeshingEngine_CPU<TVoxel, ITMVoxelBlockHash>::FindOccupiedTiles(std::vector<Vector3i> &tiles, const ITMScene<TVoxel, ITMVoxelBlockHash> *scene,
+	int tileSize)
+{
+	const ITMHashEntry *hashTable = scene->index.GetEntries();
+	int noTotalEntries = scene->index.noTotalEntries;
+
+	tiles.clear();
+	for (int entryId = 0; entryId < noTotalEntries; entryId++)
+	{
+		const ITMHashEntry &hashEntry = hashTable[entryId];
+		if (hashEntry.ptr < 0) continue;
+
+		tiles.push_back(Vector3i(floorDiv(hashEntry.pos.x, tileSize), floorDiv(hashEntry.pos.y, tileSize), floorDiv(hashEntry.pos.z, tileSize)));
+	}
+
+	std::sort(tiles.begin(), tiles.end(), tileLess);
+	tiles.erase(std::unique(tiles.begin(), tiles.end(), sameTile), tiles.end());
+}
+
+template<class TVoxel>
+ITMScene<TVoxel, ITMVoxelBlockHash>* ITMMeshingEngine_CPU<TVoxel, ITMVoxelBlockHash>::MakeSceneSnapshot(const ITMScene<TVoxel, ITMVoxelBlockHash> *scene)
+{
+	const ITMHashEntry *hashTable = scene->index.GetEntries();
+	const TVoxel *localVBA = scene->localVBA.GetVoxelBlocks();
+	int noTotalEntries = scene->index.noTotalEntries;
+
+	// the allocated blocks are packed in the order of their entries
+	std::vector<int> entryIds;
+	for (int entryId = 0; entryId < noTotalEntries; entryId++)
+		if (hashTable[entryId].ptr >= 0) entryIds.push_back(entryId);
+
+	int noBlocks = (int)entryIds.size();
+	ITMScene<TVoxel, ITMVoxelBlockHash> *snapshot = new ITMScene<TVoxel, ITMVoxelBlockHash>(scene->sceneParams, false, MEMORYDEVICE_CPU, MAX(noBlocks, 1));
+	ITMHashEntry *snapshotHashTable = snapshot->index.GetEntries();
+	TVoxel *snapshotVBA = snapshot->localVBA.GetVoxelBlocks();
+
+	memcpy(snapshotHashTable, hashTable, noTotalEntries * sizeof(ITMHashEntry));
+
+#ifdef WITH_OPENMP
+	#pragma omp parallel for
+#endif
+	for (int blockId = 0; blockId < noBlocks; blockId++)
+	{
+		ITMHashEntry &hashEntry = snapshotHashTable[entryIds[blockId]];
+		memcpy(snapshotVBA + blockId * SDF_BLOCK_SIZE3, localVBA + hashEntry.ptr * SDF_BLOCK_SIZE3, SDF_BLOCK_SIZE3 * sizeof(TVoxel));
+		hashEntry.ptr = blockId;
+	}
+
+	// the snapshot is meant to be read only, it has no free blocks
+	snapshot->localVBA.lastFreeBlockId = -1;
+	snapshot->index.MarkAllModified();
+
+	return snapshot;
+}
@@ -11,17 +11,21 @@ namespace ITMLib
 	class ITMMultiMeshingEngine_CPU : public ITMMultiMeshingEngine<TVoxel, TIndex>
 	{
 	public:
-		void MeshScene(ITMMesh *mesh, const ITMVoxelMapGraphManager<TVoxel, TIndex> & sceneManager) {}
+		void MeshScene(ITMMesh *mesh, const ITMVoxelMapGraphManager<TVoxel, TIndex> & sceneManager, bool deduplicateOverlaps = false) {}
 	};
 
 	template<class TVoxel>
 	class ITMMultiMeshingEngine_CPU<TVoxel, ITMVoxelBlockHash> : public ITMMultiMeshingEngine < TVoxel, ITMVoxelBlockHash >
 	{
+	private:
+		/// Number of allocated blocks, possibly of several local maps, meshed as one unit of work
+		static const int noBlocksPerChunk = 64;
+
 	public:
 		typedef typename ITMMultiIndex<ITMVoxelBlockHash>::IndexData MultiIndexData;
 		typedef ITMMultiVoxel<TVoxel> MultiVoxelData;
 		typedef ITMVoxelMapGraphManager<TVoxel, ITMVoxelBlockHash> MultiSceneManager;
 
-		void MeshScene(ITMMesh *mesh, const MultiSceneManager & sceneManager);
+		void MeshScene(ITMMesh *mesh, const MultiSceneManager & sceneManager, bool deduplicateOverlaps = false);
 	};
 }
\ No newline at end of file
@@ -4,10 +4,13 @@
 
 #include "../Shared/ITMMultiMeshingEngine_Shared.h"
 
+#include <algorithm>
+#include <vector>
+
 using namespace ITMLib;
 
 template<class TVoxel>
-inline void ITMMultiMeshingEngine_CPU<TVoxel, ITMVoxelBlockHash>::MeshScene(ITMMesh * mesh, const MultiSceneManager & sceneManager)
+inline void ITMMultiMeshingEngine_CPU<TVoxel, ITMVoxelBlockHash>::MeshScene(ITMMesh * mesh, const MultiSceneManager & sceneManager, bool deduplicateOverlaps)
 {
 	int numLocalMaps = (int)sceneManager.numLocalMaps();
 	if (numLocalMaps > MAX_NUM_LOCALMAPS) numLocalMaps = MAX_NUM_LOCALMAPS;
@@ -33,25 +36,37 @@ inline void ITMMultiMeshingEngine_CPU<TVoxel, ITMVoxelBlockHash>::MeshScene(ITMM
 		localVBAs.voxels[localMapId] = sceneManager.getLocalMap(localMapId)->scene->localVBA.GetVoxelBlocks();
 	}
 
-	ITMMesh::Triangle *triangles = mesh->triangles->GetData(MEMORYDEVICE_CPU);
-	mesh->triangles->Clear();
-
-	int noTriangles = 0, noMaxTriangles = mesh->noMaxTriangles, noTotalEntriesPerLocalMap = ITMVoxelBlockHash::noTotalEntries;
+	int noTotalEntriesPerLocalMap = ITMVoxelBlockHash::noTotalEntries;
 	float factor = sceneParams.voxelSize;
 
-	// very dumb rendering -- likely to generate lots of duplicates
+	// the allocated blocks of all local maps are listed in (local map, entry) order and meshed in fixed ranges
+	// of that list, each into its own list of triangles; concatenating these afterwards gives the same output
+	// for any number of threads, and the work is balanced across local maps of very different sizes
+	std::vector<Vector2i> allocatedBlocks;
 	for (int localMapId = 0; localMapId < numLocalMaps; ++localMapId)
 	{
-		ITMHashEntry *hashTable = hashTables.index[localMapId];
-
+		const ITMHashEntry *hashTable = hashTables.index[localMapId];
 		for (int entryId = 0; entryId < noTotalEntriesPerLocalMap; entryId++)
-		{
-			Vector3i globalPos;
-			const ITMHashEntry &currentHashEntry = hashTable[entryId];
+			if (hashTable[entryId].ptr >= 0) allocatedBlocks.push_back(Vector2i(localMapId, entryId));
+	}
+
+	int noBlocks = (int)allocatedBlocks.size();
+	int noChunks = (noBlocks + noBlocksPerChunk - 1) / noBlocksPerChunk;
+	std::vector<std::vector<ITMMesh::Triangle> > chunkTriangles(noChunks);
 
-			if (currentHashEntry.ptr < 0) continue;
+#ifdef WITH_OPENMP
+	#pragma omp parallel for schedule(dynamic)
+#endif
+	for (int chunkId = 0; chunkId < noChunks; chunkId++)
+	{
+		std::vector<ITMMesh::Triangle> &triangles_chunk = chunkTriangles[chunkId];
+		int blockEnd = MIN((chunkId + 1) * noBlocksPerChunk, noBlocks);
 
-			globalPos = currentHashEntry.pos.toInt() * SDF_BLOCK_SIZE;
+		for (int blockId = chunkId * noBlocksPerChunk; blockId < blockEnd; blockId++)
+		{
+			int localMapId = allocatedBlocks[blockId].x;
+			const ITMHashEntry &currentHashEntry = hashTables.index[localMapId][allocatedBlocks[blockId].y];
+			Vector3i globalPos = currentHashEntry.pos.toInt() * SDF_BLOCK_SIZE;
 
 			for (int z = 0; z < SDF_BLOCK_SIZE; z++) for (int y = 0; y < SDF_BLOCK_SIZE; y++) for (int x = 0; x < SDF_BLOCK_SIZE; x++)
 			{
@@ -59,18 +74,34 @@ inline void ITMMultiMeshingEngine_CPU<TVoxel, ITMVoxelBlockHash>::MeshScene(ITMM
 				int cubeIndex = buildVertListMulti(vertList, globalPos, Vector3i(x, y, z), &localVBAs, &hashTables, localMapId);
 
 				if (cubeIndex < 0) continue;
+				if (deduplicateOverlaps && isMeshedByEarlierLocalMap(globalPos + Vector3i(x, y, z), &localVBAs, &hashTables, localMapId)) continue;
 
 				for (int i = 0; triangleTable[cubeIndex][i] != -1; i += 3)
 				{
-					triangles[noTriangles].p0 = vertList[triangleTable[cubeIndex][i]] * factor;
-					triangles[noTriangles].p1 = vertList[triangleTable[cubeIndex][i + 1]] * factor;
-					triangles[noTriangles].p2 = vertList[triangleTable[cubeIndex][i + 2]] * factor;
-
-					if (noTriangles < noMaxTriangles - 1) noTriangles++;
+					ITMMesh::Triangle triangle;
+					triangle.p0 = vertList[triangleTable[cubeIndex][i]] * factor;
+					triangle.p1 = vertList[triangleTable[cubeIndex][i + 1]] * factor;
+					triangle.p2 = vertList[triangleTable[cubeIndex][i + 2]] * factor;
+					triangles_chunk.push_back(triangle);
 				}
 			}
 		}
 	}
 
-	mesh->noTotalTriangles = noTriangles;
-}
\ No newline at end of file
+	uint noTriangles = 0;
+	for (int chunkId = 0; chunkId < noChunks; chunkId++) noTriangles += (uint)chunkTriangles[chunkId].size();
+
+	uint noStoredTriangles = mesh->ReserveTriangles(noTriangles);
+	ITMMesh::Triangle *triangles = mesh->triangles->GetData(MEMORYDEVICE_CPU);
+
+	for (int chunkId = 0, offset = 0; chunkId < noChunks && (uint)offset < noStoredTriangles; chunkId++)
+	{
+		const std::vector<ITMMesh::Triangle> &triangles_chunk = chunkTriangles[chunkId];
+		int noCopied = MIN((int)triangles_chunk.size(), (int)noStoredTriangles - offset);
+
+		std::copy(triangles_chunk.begin(), triangles_chunk.begin() + noCopied, triangles + offset);
+		offset += noCopied;
+	}
+
+	mesh->SetNoProducedTriangles(noTriangles);
+}
@@ -15,11 +15,26 @@ namespace ITMLib
 	class ITMMeshingEngine_CUDA<TVoxel, ITMVoxelBlockHash> : public ITMMeshingEngine < TVoxel, ITMVoxelBlockHash >
 	{
 	private:
+		/// Number of blocks meshed at a time when streaming to a writer, and the size of the buffer their triangles are copied through
+		static const int noBlocksPerBatch = 4096;
+		static const int noTrianglesPerBatch = 1 << 20;
+
 		unsigned int  *noTriangles_device;
 		Vector4s *visibleBlockGlobalPos_device;
 
+		/// Mesh the blocks marked in visibleBlockGlobalPos_device, with cells of voxelStride voxels
+		void MeshListedBlocks(ITMMesh *mesh, const ITMScene<TVoxel, ITMVoxelBlockHash> *scene, int voxelStride);
+		/// Copy a triangle soup meshed on the GPU to the CPU and weld it
+		void WeldTriangles(ITMIndexedMesh *mesh, const ITMMesh *triangleMesh);
+
 	public:
 		void MeshScene(ITMMesh *mesh, const ITMScene<TVoxel, ITMVoxelBlockHash> *scene);
+		void MeshScene(ITMIndexedMesh *mesh, const ITMScene<TVoxel, ITMVoxelBlockHash> *scene);
+		void MeshScene(ITMMesh *mesh, const ITMScene<TVoxel, ITMVoxelBlockHash> *scene, const ITMMeshRegion &region, int voxelStride = 1);
+		void MeshScene(ITMIndexedMesh *mesh, const ITMScene<TVoxel, ITMVoxelBlockHash> *scene, const ITMMeshRegion &region, int voxelStride = 1);
+		void MeshScene(ITMMeshWriter *writer, const ITMScene<TVoxel, ITMVoxelBlockHash> *scene);
+		void FindOccupiedTiles(std::vector<Vector3i> &tiles, const ITMScene<TVoxel, ITMVoxelBlockHash> *scene, int tileSize);
+		ITMScene<TVoxel, ITMVoxelBlockHash>* MakeSceneSnapshot(const ITMScene<TVoxel, ITMVoxelBlockHash> *scene);
 
 		ITMMeshingEngine_CUDA(void);
 		~ITMMeshingEngine_CUDA(void);
@@ -30,6 +45,12 @@ namespace ITMLib
 	{
 	public:
 		void MeshScene(ITMMesh *mesh, const ITMScene<TVoxel, ITMPlainVoxelArray> *scene);
+		void MeshScene(ITMIndexedMesh *mesh, const ITMScene<TVoxel, ITMPlainVoxelArray> *scene);
+		void MeshScene(ITMMesh *mesh, const ITMScene<TVoxel, ITMPlainVoxelArray> *scene, const ITMMeshRegion &region, int voxelStride = 1);
+		void MeshScene(ITMIndexedMesh *mesh, const ITMScene<TVoxel, ITMPlainVoxelArray> *scene, const ITMMeshRegion &region, int voxelStride = 1);
+		void MeshScene(ITMMeshWriter *writer, const ITMScene<TVoxel, ITMPlainVoxelArray> *scene);
+		void FindOccupiedTiles(std::vector<Vector3i> &tiles, const ITMScene<TVoxel, ITMPlainVoxelArray> *scene, int tileSize);
+		ITMScene<TVoxel, ITMPlainVoxelArray>* MakeSceneSnapshot(const ITMScene<TVoxel, ITMPlainVoxelArray> *scene);
 
 		ITMMeshingEngine_CUDA(void);
 		~ITMMeshingEngine_CUDA(void);
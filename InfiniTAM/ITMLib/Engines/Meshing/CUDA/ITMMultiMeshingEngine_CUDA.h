@@ -11,7 +11,7 @@ namespace ITMLib
 	class ITMMultiMeshingEngine_CUDA : public ITMMultiMeshingEngine<TVoxel, TIndex>
 	{
 	public:
-		void MeshScene(ITMMesh *mesh, const ITMVoxelMapGraphManager<TVoxel, TIndex> & sceneManager) {}
+		void MeshScene(ITMMesh *mesh, const ITMVoxelMapGraphManager<TVoxel, TIndex> & sceneManager, bool deduplicateOverlaps = false) {}
 	};
 
 	template<class TVoxel>
@@ -29,7 +29,7 @@ namespace ITMLib
 		MultiIndexData *indexData_device, indexData_host;
 		MultiVoxelData *voxelData_device, voxelData_host;
 
-		void MeshScene(ITMMesh *mesh, const MultiSceneManager & sceneManager);
+		void MeshScene(ITMMesh *mesh, const MultiSceneManager & sceneManager, bool deduplicateOverlaps = false);
 
 		ITMMultiMeshingEngine_CUDA(void);
 		~ITMMultiMeshingEngine_CUDA(void);
@@ -3,8 +3,11 @@
 #pragma once
 
 #include <math.h>
+#include <vector>
 
-#include "../../../Objects/Meshing/ITMMesh.h"
+#include "../../../Objects/Meshing/ITMIndexedMesh.h"
+#include "../../../Objects/Meshing/ITMMeshRegion.h"
+#include "../../../Objects/Meshing/ITMMeshWriter.h"
 #include "../../../Objects/Scene/ITMScene.h"
 
 namespace ITMLib
@@ -15,6 +18,45 @@ namespace ITMLib
 	public:
 		virtual void MeshScene(ITMMesh *mesh, const ITMScene<TVoxel,TIndex> *scene) = 0;
 
+		/** Extracts the scene's surface as an indexed mesh, in which
+		    the vertices on cell edges are shared between triangles.
+		    Normals and colours are added as the mesh requests them
+		    and the engine and voxel type can provide them.
+		*/
+		virtual void MeshScene(ITMIndexedMesh *mesh, const ITMScene<TVoxel,TIndex> *scene) = 0;
+
+		/** Extracts the mesh of the blocks that overlap the region.
+		    The blocks are selected by their coordinates, so that the
+		    cost depends on the size of the region rather than of the
+		    scene. With a voxelStride of 2, 4 or 8 the SDF is sampled
+		    at every voxelStride-th voxel only, which gives a coarser
+		    mesh for levels of detail.
+		*/
+		virtual void MeshScene(ITMMesh *mesh, const ITMScene<TVoxel,TIndex> *scene, const ITMMeshRegion &region, int voxelStride = 1) = 0;
+		virtual void MeshScene(ITMIndexedMesh *mesh, const ITMScene<TVoxel,TIndex> *scene, const ITMMeshRegion &region, int voxelStride = 1) = 0;
+
+		/** Meshes the scene a batch of blocks at a time and passes
+		    the triangles of each batch to the open writer, so that
+		    the memory used does not grow with the size of the mesh.
+		    The triangles are those of MeshScene for a triangle soup,
+		    but are never dropped.
+		*/
+		virtual void MeshScene(ITMMeshWriter *writer, const ITMScene<TVoxel,TIndex> *scene) = 0;
+
+		/** Lists the coordinates of the tiles of tileSize^3 blocks
+		    that contain allocated blocks, in ascending order.
+		*/
+		virtual void FindOccupiedTiles(std::vector<Vector3i> &tiles, const ITMScene<TVoxel,TIndex> *scene, int tileSize) = 0;
+
+		/** Copies the allocated blocks of the scene into a new scene
+		    on the same device, packed into a local VBA just large
+		    enough for them, which can be meshed while the original
+		    keeps changing. The caller owns the snapshot. Swapped out
+		    blocks are not included. Returns NULL if the index type
+		    is not supported.
+		*/
+		virtual ITMScene<TVoxel,TIndex>* MakeSceneSnapshot(const ITMScene<TVoxel,TIndex> *scene) = 0;
+
 		ITMMeshingEngine(void) { }
 		virtual ~ITMMeshingEngine(void) { }
 	};
@@ -14,6 +14,11 @@ namespace ITMLib
 	public:
 		virtual ~ITMMultiMeshingEngine(void) {}
 
-		virtual void MeshScene(ITMMesh *mesh, const ITMVoxelMapGraphManager<TVoxel, TIndex> & sceneManager) = 0;
+		/** Meshes all local maps in the frame of the global poses
+		    estimated for them. With deduplicateOverlaps, regions
+		    covered by several maps are meshed by the earliest of
+		    them only, rather than once per map.
+		*/
+		virtual void MeshScene(ITMMesh *mesh, const ITMVoxelMapGraphManager<TVoxel, TIndex> & sceneManager, bool deduplicateOverlaps = false) = 0;
 	};
 }
\ No newline at end of file
@@ -149,9 +149,15 @@ static const _CPU_AND_GPU_CONSTANT_ int triangleTable[256][16] = { { -1, -1, -1,
 { 0, 9, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 }, { 0, 3, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
 { -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 } };
 
+/// For each of the 12 cell edges, the offset of its lower corner from the cell's voxel and the axis (0: x, 1: y, 2: z)
+/// along which it runs. The lower corner's voxel and the axis identify an edge shared by up to four cells.
+static const _CPU_AND_GPU_CONSTANT_ int edgeOrigin[12][4] = { { 0, 0, 0, 0 }, { 1, 0, 0, 1 }, { 0, 1, 0, 0 }, { 0, 0, 0, 1 },
+	{ 0, 0, 1, 0 }, { 1, 0, 1, 1 }, { 0, 1, 1, 0 }, { 0, 0, 1, 1 }, { 0, 0, 0, 2 }, { 1, 0, 0, 2 }, { 1, 1, 0, 2 }, { 0, 1, 0, 2 } };
+
+/// Reads the corners of the cell at blockLocation, whose edges are stride voxels long
 template<class TVoxel>
 _CPU_AND_GPU_CODE_ inline bool findPointNeighbors(THREADPTR(Vector3f) *p, THREADPTR(float) *sdf, Vector3i blockLocation, const CONSTPTR(TVoxel) *localVBA, 
-	const CONSTPTR(ITMHashEntry) *hashTable)
+	const CONSTPTR(ITMHashEntry) *hashTable, int stride = 1)
 {
 	int vmIndex; Vector3i localBlockLocation;
 
@@ -159,31 +165,31 @@ _CPU_AND_GPU_CODE_ inline bool findPointNeighbors(THREADPTR(Vector3f) *p, THREAD
 	sdf[0] = TVoxel::valueToFloat(readVoxel(localVBA, hashTable, localBlockLocation, vmIndex).sdf);
 	if (!vmIndex || sdf[0] == 1.0f) return false;
 
-	localBlockLocation = blockLocation + Vector3i(1, 0, 0); p[1] = localBlockLocation.toFloat();
+	localBlockLocation = blockLocation + Vector3i(1, 0, 0) * stride; p[1] = localBlockLocation.toFloat();
 	sdf[1] = TVoxel::valueToFloat(readVoxel(localVBA, hashTable, localBlockLocation, vmIndex).sdf);
 	if (!vmIndex || sdf[1] == 1.0f) return false;
 
-	localBlockLocation = blockLocation + Vector3i(1, 1, 0); p[2] = localBlockLocation.toFloat();
+	localBlockLocation = blockLocation + Vector3i(1, 1, 0) * stride; p[2] = localBlockLocation.toFloat();
 	sdf[2] = TVoxel::valueToFloat(readVoxel(localVBA, hashTable, localBlockLocation, vmIndex).sdf);
 	if (!vmIndex || sdf[2] == 1.0f) return false;
 
-	localBlockLocation = blockLocation + Vector3i(0, 1, 0); p[3] = localBlockLocation.toFloat();
+	localBlockLocation = blockLocation + Vector3i(0, 1, 0) * stride; p[3] = localBlockLocation.toFloat();
 	sdf[3] = TVoxel::valueToFloat(readVoxel(localVBA, hashTable, localBlockLocation, vmIndex).sdf);
 	if (!vmIndex || sdf[3] == 1.0f) return false;
 
-	localBlockLocation = blockLocation + Vector3i(0, 0, 1); p[4] = localBlockLocation.toFloat();
+	localBlockLocation = blockLocation + Vector3i(0, 0, 1) * stride; p[4] = localBlockLocation.toFloat();
 	sdf[4] = TVoxel::valueToFloat(readVoxel(localVBA, hashTable, localBlockLocation, vmIndex).sdf);
 	if (!vmIndex || sdf[4] == 1.0f) return false;
 
-	localBlockLocation = blockLocation + Vector3i(1, 0, 1); p[5] = localBlockLocation.toFloat();
+	localBlockLocation = blockLocation + Vector3i(1, 0, 1) * stride; p[5] = localBlockLocation.toFloat();
 	sdf[5] = TVoxel::valueToFloat(readVoxel(localVBA, hashTable, localBlockLocation, vmIndex).sdf);
 	if (!vmIndex || sdf[5] == 1.0f) return false;
 
-	localBlockLocation = blockLocation + Vector3i(1, 1, 1); p[6] = localBlockLocation.toFloat();
+	localBlockLocation = blockLocation + Vector3i(1, 1, 1) * stride; p[6] = localBlockLocation.toFloat();
 	sdf[6] = TVoxel::valueToFloat(readVoxel(localVBA, hashTable, localBlockLocation, vmIndex).sdf);
 	if (!vmIndex || sdf[6] == 1.0f) return false;
 
-	localBlockLocation = blockLocation + Vector3i(0, 1, 1); p[7] = localBlockLocation.toFloat();
+	localBlockLocation = blockLocation + Vector3i(0, 1, 1) * stride; p[7] = localBlockLocation.toFloat();
 	sdf[7] = TVoxel::valueToFloat(readVoxel(localVBA, hashTable, localBlockLocation, vmIndex).sdf);
 	if (!vmIndex || sdf[7] == 1.0f) return false;
 
@@ -200,11 +206,12 @@ _CPU_AND_GPU_CODE_ inline Vector3f sdfInterp(const THREADPTR(Vector3f) &p1, cons
 }
 
 template<class TVoxel>
-_CPU_AND_GPU_CODE_ inline int buildVertList(THREADPTR(Vector3f) *vertList, Vector3i globalPos, Vector3i localPos, const CONSTPTR(TVoxel) *localVBA, const CONSTPTR(ITMHashEntry) *hashTable)
+_CPU_AND_GPU_CODE_ inline int buildVertList(THREADPTR(Vector3f) *vertList, Vector3i globalPos, Vector3i localPos, const CONSTPTR(TVoxel) *localVBA, const CONSTPTR(ITMHashEntry) *hashTable,
+	int stride = 1)
 {
 	Vector3f points[8]; float sdfVals[8];
 
-	if (!findPointNeighbors(points, sdfVals, globalPos + localPos, localVBA, hashTable)) return -1;
+	if (!findPointNeighbors(points, sdfVals, globalPos + localPos, localVBA, hashTable, stride)) return -1;
 
 	int cubeIndex = 0;
 	if (sdfVals[0] < 0) cubeIndex |= 1; if (sdfVals[1] < 0) cubeIndex |= 2;
@@ -214,14 +221,16 @@ _CPU_AND_GPU_CODE_ inline int buildVertList(THREADPTR(Vector3f) *vertList, Vecto
 
 	if (edgeTable[cubeIndex] == 0) return -1;
 
+	// every edge is interpolated from its lower to its upper corner, so that neighbouring cells produce bit-identical
+	// vertices on the edges they share
 	if (edgeTable[cubeIndex] & 1) vertList[0] = sdfInterp(points[0], points[1], sdfVals[0], sdfVals[1]);
 	if (edgeTable[cubeIndex] & 2) vertList[1] = sdfInterp(points[1], points[2], sdfVals[1], sdfVals[2]);
-	if (edgeTable[cubeIndex] & 4) vertList[2] = sdfInterp(points[2], points[3], sdfVals[2], sdfVals[3]);
-	if (edgeTable[cubeIndex] & 8) vertList[3] = sdfInterp(points[3], points[0], sdfVals[3], sdfVals[0]);
+	if (edgeTable[cubeIndex] & 4) vertList[2] = sdfInterp(points[3], points[2], sdfVals[3], sdfVals[2]);
+	if (edgeTable[cubeIndex] & 8) vertList[3] = sdfInterp(points[0], points[3], sdfVals[0], sdfVals[3]);
 	if (edgeTable[cubeIndex] & 16) vertList[4] = sdfInterp(points[4], points[5], sdfVals[4], sdfVals[5]);
 	if (edgeTable[cubeIndex] & 32) vertList[5] = sdfInterp(points[5], points[6], sdfVals[5], sdfVals[6]);
-	if (edgeTable[cubeIndex] & 64) vertList[6] = sdfInterp(points[6], points[7], sdfVals[6], sdfVals[7]);
-	if (edgeTable[cubeIndex] & 128) vertList[7] = sdfInterp(points[7], points[4], sdfVals[7], sdfVals[4]);
+	if (edgeTable[cubeIndex] & 64) vertList[6] = sdfInterp(points[7], points[6], sdfVals[7], sdfVals[6]);
+	if (edgeTable[cubeIndex] & 128) vertList[7] = sdfInterp(points[4], points[7], sdfVals[4], sdfVals[7]);
 	if (edgeTable[cubeIndex] & 256) vertList[8] = sdfInterp(points[0], points[4], sdfVals[0], sdfVals[4]);
 	if (edgeTable[cubeIndex] & 512) vertList[9] = sdfInterp(points[1], points[5], sdfVals[1], sdfVals[5]);
 	if (edgeTable[cubeIndex] & 1024) vertList[10] = sdfInterp(points[2], points[6], sdfVals[2], sdfVals[6]);
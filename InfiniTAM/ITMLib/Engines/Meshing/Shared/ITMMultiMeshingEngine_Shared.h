@@ -72,16 +72,37 @@ _CPU_AND_GPU_CODE_ inline int buildVertListMulti(THREADPTR(Vector3f) *vertList,
 
 	if (edgeTable[cubeIndex] & 1) vertList[0] = sdfInterp(points[0], points[1], sdfVals[0], sdfVals[1]);
 	if (edgeTable[cubeIndex] & 2) vertList[1] = sdfInterp(points[1], points[2], sdfVals[1], sdfVals[2]);
-	if (edgeTable[cubeIndex] & 4) vertList[2] = sdfInterp(points[2], points[3], sdfVals[2], sdfVals[3]);
-	if (edgeTable[cubeIndex] & 8) vertList[3] = sdfInterp(points[3], points[0], sdfVals[3], sdfVals[0]);
+	if (edgeTable[cubeIndex] & 4) vertList[2] = sdfInterp(points[3], points[2], sdfVals[3], sdfVals[2]);
+	if (edgeTable[cubeIndex] & 8) vertList[3] = sdfInterp(points[0], points[3], sdfVals[0], sdfVals[3]);
 	if (edgeTable[cubeIndex] & 16) vertList[4] = sdfInterp(points[4], points[5], sdfVals[4], sdfVals[5]);
 	if (edgeTable[cubeIndex] & 32) vertList[5] = sdfInterp(points[5], points[6], sdfVals[5], sdfVals[6]);
-	if (edgeTable[cubeIndex] & 64) vertList[6] = sdfInterp(points[6], points[7], sdfVals[6], sdfVals[7]);
-	if (edgeTable[cubeIndex] & 128) vertList[7] = sdfInterp(points[7], points[4], sdfVals[7], sdfVals[4]);
+	if (edgeTable[cubeIndex] & 64) vertList[6] = sdfInterp(points[7], points[6], sdfVals[7], sdfVals[6]);
+	if (edgeTable[cubeIndex] & 128) vertList[7] = sdfInterp(points[4], points[7], sdfVals[4], sdfVals[7]);
 	if (edgeTable[cubeIndex] & 256) vertList[8] = sdfInterp(points[0], points[4], sdfVals[0], sdfVals[4]);
 	if (edgeTable[cubeIndex] & 512) vertList[9] = sdfInterp(points[1], points[5], sdfVals[1], sdfVals[5]);
 	if (edgeTable[cubeIndex] & 1024) vertList[10] = sdfInterp(points[2], points[6], sdfVals[2], sdfVals[6]);
 	if (edgeTable[cubeIndex] & 2048) vertList[11] = sdfInterp(points[3], points[7], sdfVals[3], sdfVals[7]);
 
 	return cubeIndex;
-}
\ No newline at end of file
+}
+
+/** Whether the centre of the cell at cellPos, in voxel coordinates of local
+    map hashTableIdx, falls into an allocated voxel of a local map with a lower
+    index. Cells in overlapping regions are meshed once, by the earliest map.
+*/
+template<class TVoxel, class TIndex>
+_CPU_AND_GPU_CODE_ inline bool isMeshedByEarlierLocalMap(Vector3i cellPos, const CONSTPTR(TVoxel) *localVBA, const CONSTPTR(TIndex) *hashTables, int hashTableIdx)
+{
+	Vector3f cellCentre = hashTables->posesInv[hashTableIdx] * (cellPos.toFloat() + Vector3f(0.5f));
+
+	for (int localMapId = 0; localMapId < hashTableIdx; ++localMapId)
+	{
+		Vector3f point_local = hashTables->poses_vs[localMapId] * cellCentre;
+
+		int vmIndex;
+		readVoxel(localVBA->voxels[localMapId], hashTables->index[localMapId], Vector3i((int)ROUND(point_local.x), (int)ROUND(point_local.y), (int)ROUND(point_local.z)), vmIndex);
+		if (vmIndex) return true;
+	}
+
+	return false;
+}
@@ -42,6 +42,8 @@ void ITMSceneReconstructionEngine_CPU<TVoxel,ITMVoxelBlockHash>::ResetScene(ITMS
 	for (int i = 0; i < SDF_EXCESS_LIST_SIZE; ++i) excessList_ptr[i] = i;
 
 	scene->index.SetLastFreeExcessListId(SDF_EXCESS_LIST_SIZE - 1);
+	scene->index.ResetModificationStamps();
+	scene->index.ResetAllocationBounds();
 }
 
 template<class TVoxel>
@@ -74,6 +76,9 @@ void ITMSceneReconstructionEngine_CPU<TVoxel, ITMVoxelBlockHash>::IntegrateIntoS
 	int *visibleEntryIds = renderState_vh->GetVisibleEntryIDs();
 	int noVisibleEntries = renderState_vh->noVisibleEntries;
 
+	uint *modificationStamps = scene->index.GetModificationStamps();
+	uint modificationStamp = scene->index.AdvanceModificationCount();
+
 	bool stopIntegratingAtMaxW = scene->sceneParams->stopIntegratingAtMaxW;
 	//bool approximateIntegration = !trackingState->requiresFullRendering;
 
@@ -87,6 +92,8 @@ void ITMSceneReconstructionEngine_CPU<TVoxel, ITMVoxelBlockHash>::IntegrateIntoS
 
 		if (currentHashEntry.ptr < 0) continue;
 
+		modificationStamps[visibleEntryIds[entryId]] = modificationStamp;
+
 		globalPos.x = currentHashEntry.pos.x;
 		globalPos.y = currentHashEntry.pos.y;
 		globalPos.z = currentHashEntry.pos.z;
@@ -122,17 +129,14 @@ void ITMSceneReconstructionEngine_CPU<TVoxel, ITMVoxelBlockHash>::AllocateSceneF
 	float voxelSize = scene->sceneParams->voxelSize;
 
 	Matrix4f M_d, invM_d;
-	Vector4f projParams_d, invProjParams_d;
 
 	ITMRenderState_VH *renderState_vh = (ITMRenderState_VH*)renderState;
 	if (resetVisibleList) renderState_vh->noVisibleEntries = 0;
 
 	M_d = trackingState->pose_d->GetM(); M_d.inv(invM_d);
 
-	projParams_d = view->calib.intrinsics_d.projectionParamsSimple.all;
-	invProjParams_d = projParams_d;
-	invProjParams_d.x = 1.0f / invProjParams_d.x;
-	invProjParams_d.y = 1.0f / invProjParams_d.y;
+	Vector4f projParams_d = view->calib.intrinsics_d.projectionParamsSimple.all;
+	const Vector4f *rayDirections = renderState->GetRayDirections(projParams_d, depthImgSize);
 
 	float mu = scene->sceneParams->mu;
 
@@ -167,11 +171,8 @@ void ITMSceneReconstructionEngine_CPU<TVoxel, ITMVoxelBlockHash>::AllocateSceneF
 #endif
 	for (int locId = 0; locId < depthImgSize.x*depthImgSize.y; locId++)
 	{
-		int y = locId / depthImgSize.x;
-		int x = locId - y * depthImgSize.x;
-		buildHashAllocAndVisibleTypePP(entriesAllocType, entriesVisibleType, x, y, blockCoords, depth, invM_d,
-			invProjParams_d, mu, depthImgSize, oneOverVoxelSize, hashTable, scene->sceneParams->viewFrustum_min,
-			scene->sceneParams->viewFrustum_max);
+		buildHashAllocAndVisibleTypePP(entriesAllocType, entriesVisibleType, locId, rayDirections[locId], blockCoords, depth, invM_d,
+			mu, oneOverVoxelSize, hashTable, scene->sceneParams->viewFrustum_min, scene->sceneParams->viewFrustum_max);
 	}
 
 	if (onlyUpdateVisibleList) useSwapping = false;
@@ -198,6 +199,7 @@ void ITMSceneReconstructionEngine_CPU<TVoxel, ITMVoxelBlockHash>::AllocateSceneF
 					hashEntry.offset = 0;
 
 					hashTable[targetIdx] = hashEntry;
+					scene->index.GrowAllocationBounds(hashEntry.pos);
 				}
 				else
 				{
@@ -227,6 +229,7 @@ void ITMSceneReconstructionEngine_CPU<TVoxel, ITMVoxelBlockHash>::AllocateSceneF
 					hashTable[targetIdx].offset = exlOffset + 1; //connect to child
 
 					hashTable[SDF_BUCKET_NUM + exlOffset] = hashEntry; //add child to the excess list
+					scene->index.GrowAllocationBounds(hashEntry.pos);
 
 					entriesVisibleType[SDF_BUCKET_NUM + exlOffset] = 1; //make child visible and in memory
 				}
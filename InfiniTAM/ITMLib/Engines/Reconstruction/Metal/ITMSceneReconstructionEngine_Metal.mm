@@ -77,6 +77,12 @@ void ITMSceneReconstructionEngine_Metal<TVoxel,ITMVoxelBlockHash>::IntegrateInto
 
     [commandBuffer commit];
 
+    // the visible list is in shared memory, so the integrated entries are stamped on the host
+    const int *visibleEntryIDs = renderState_vh->GetVisibleEntryIDs();
+    uint *modificationStamps = scene->index.GetModificationStamps();
+    uint modificationStamp = scene->index.AdvanceModificationCount();
+    for (int i = 0; i < renderState_vh->noVisibleEntries; i++) modificationStamps[visibleEntryIDs[i]] = modificationStamp;
+
 //    [commandBuffer waitUntilCompleted];
 }
 
@@ -209,6 +215,7 @@ void ITMSceneReconstructionEngine_Metal<TVoxel, ITMVoxelBlockHash>::AllocateScen
                         hashEntry.offset = 0;
 
                         hashTable[targetIdx] = hashEntry;
+                        scene->index.GrowAllocationBounds(hashEntry.pos);
                     }
 
                     break;
@@ -230,6 +237,7 @@ void ITMSceneReconstructionEngine_Metal<TVoxel, ITMVoxelBlockHash>::AllocateScen
                         hashTable[targetIdx].offset = exlOffset + 1; //connect to child
 
                         hashTable[SDF_BUCKET_NUM + exlOffset] = hashEntry; //add child to the excess list
+                        scene->index.GrowAllocationBounds(hashEntry.pos);
 
                         entriesVisibleType[SDF_BUCKET_NUM + exlOffset] = 1; //make child visible and in memory
                     }
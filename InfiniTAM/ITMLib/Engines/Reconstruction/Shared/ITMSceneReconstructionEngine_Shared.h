@@ -4,6 +4,7 @@
 
 #include "../../../Objects/Scene/ITMRepresentationAccess.h"
 #include "../../../Utils/ITMPixelUtils.h"
+#include "../../../Utils/ITMProjectionUtils.h"
 
 template<class TVoxel>
 _CPU_AND_GPU_CODE_ inline float computeUpdatedVoxelDepthInfo(DEVICEPTR(TVoxel) &voxel, const THREADPTR(Vector4f) & pt_model, const CONSTPTR(Matrix4f) & M_d,
@@ -181,28 +182,26 @@ struct ComputeUpdatedVoxelInfo<true, true, TVoxel> {
 	}
 };
 
-_CPU_AND_GPU_CODE_ inline void buildHashAllocAndVisibleTypePP(DEVICEPTR(uchar) *entriesAllocType, DEVICEPTR(uchar) *entriesVisibleType, int x, int y,
-	DEVICEPTR(Vector4s) *blockCoords, const CONSTPTR(float) *depth, Matrix4f invM_d, Vector4f projParams_d, float mu, Vector2i imgSize,
+/// Marks the blocks along the truncation band of pixel locId for allocation or as visible. rayDirection_camera
+/// is the pixel's entry of ITMRenderState::GetRayDirections, i.e. the unit viewing ray and its length per unit of depth.
+_CPU_AND_GPU_CODE_ inline void buildHashAllocAndVisibleTypePP(DEVICEPTR(uchar) *entriesAllocType, DEVICEPTR(uchar) *entriesVisibleType, int locId,
+	const THREADPTR(Vector4f) & rayDirection_camera, DEVICEPTR(Vector4s) *blockCoords, const CONSTPTR(float) *depth, Matrix4f invM_d, float mu,
 	float oneOverVoxelSize, const CONSTPTR(ITMHashEntry) *hashTable, float viewFrustum_min, float viewFrustum_max)
 {
 	float depth_measure; unsigned int hashIdx; int noSteps;
-	Vector4f pt_camera_f; Vector3f point_e, point, direction; Vector3s blockPos;
+	Vector3f point_e, point, direction; Vector3s blockPos;
 
-	depth_measure = depth[x + y * imgSize.x];
+	depth_measure = depth[locId];
 	if (depth_measure <= 0 || (depth_measure - mu) < 0 || (depth_measure - mu) < viewFrustum_min || (depth_measure + mu) > viewFrustum_max) return;
 
-	pt_camera_f.z = depth_measure;
-	pt_camera_f.x = pt_camera_f.z * ((float(x) - projParams_d.z) * projParams_d.x);
-	pt_camera_f.y = pt_camera_f.z * ((float(y) - projParams_d.w) * projParams_d.y);
-
-	float norm = sqrt(pt_camera_f.x * pt_camera_f.x + pt_camera_f.y * pt_camera_f.y + pt_camera_f.z * pt_camera_f.z);
+	float norm = depth_measure * rayDirection_camera.w;
 
 	Vector4f pt_buff;
-	
-	pt_buff = pt_camera_f * (1.0f - mu / norm); pt_buff.w = 1.0f;
+
+	pt_buff = rayDirection_camera * (norm - mu); pt_buff.w = 1.0f;
 	point = TO_VECTOR3(invM_d * pt_buff) * oneOverVoxelSize;
 
-	pt_buff = pt_camera_f * (1.0f + mu / norm); pt_buff.w = 1.0f;
+	pt_buff = rayDirection_camera * (norm + mu); pt_buff.w = 1.0f;
 	point_e = TO_VECTOR3(invM_d * pt_buff) * oneOverVoxelSize;
 
 	direction = point_e - point;
@@ -268,6 +267,17 @@ _CPU_AND_GPU_CODE_ inline void buildHashAllocAndVisibleTypePP(DEVICEPTR(uchar) *
 	}
 }
 
+_CPU_AND_GPU_CODE_ inline void buildHashAllocAndVisibleTypePP(DEVICEPTR(uchar) *entriesAllocType, DEVICEPTR(uchar) *entriesVisibleType, int x, int y,
+	DEVICEPTR(Vector4s) *blockCoords, const CONSTPTR(float) *depth, Matrix4f invM_d, Vector4f projParams_d, float mu, Vector2i imgSize,
+	float oneOverVoxelSize, const CONSTPTR(ITMHashEntry) *hashTable, float viewFrustum_min, float viewFrustum_max)
+{
+	Vector4f invProjParams_d(projParams_d.x, projParams_d.y, -projParams_d.z, -projParams_d.w);
+	Vector4f rayDirection_camera = computeRayDirection(x, y, invProjParams_d);
+
+	buildHashAllocAndVisibleTypePP(entriesAllocType, entriesVisibleType, x + y * imgSize.x, rayDirection_camera, blockCoords, depth, invM_d, mu,
+		oneOverVoxelSize, hashTable, viewFrustum_min, viewFrustum_max);
+}
+
 template<bool useSwapping>
 _CPU_AND_GPU_CODE_ inline void checkPointVisibility(THREADPTR(bool) &isVisible, THREADPTR(bool) &isVisibleEnlarged,
 	const THREADPTR(Vector4f) &pt_image, const CONSTPTR(Matrix4f) & M_d, const CONSTPTR(Vector4f) &projParams_d,
@@ -79,10 +79,12 @@ void ITMSwappingEngine_CPU<TVoxel, ITMVoxelBlockHash>::IntegrateGlobalIntoLocal(
 	int *neededEntryIDs_local = globalCache->GetNeededEntryIDs(false);
 
 	TVoxel *localVBA = scene->localVBA.GetVoxelBlocks();
+	uint *modificationStamps = scene->index.GetModificationStamps();
 
 	int noNeededEntries = this->LoadFromGlobalMemory(scene);
 
 	int maxW = scene->sceneParams->maxW;
+	uint modificationStamp = scene->index.AdvanceModificationCount();
 
 	for (int i = 0; i < noNeededEntries; i++)
 	{
@@ -97,6 +99,8 @@ void ITMSwappingEngine_CPU<TVoxel, ITMVoxelBlockHash>::IntegrateGlobalIntoLocal(
 			{
 				CombineVoxelInformation<TVoxel::hasColorInformation, TVoxel>::compute(srcVB[vIdx], dstVB[vIdx], maxW);
 			}
+
+			modificationStamps[entryDestId] = modificationStamp;
 		}
 
 		swapStates[entryDestId].state = 2;
@@ -124,6 +128,9 @@ void ITMSwappingEngine_CPU<TVoxel, ITMVoxelBlockHash>::SaveToGlobalMemory(ITMSce
 	TVoxel *localVBA = scene->localVBA.GetVoxelBlocks();
 	int *voxelAllocationList = scene->localVBA.GetAllocationList();
 
+	uint *modificationStamps = scene->index.GetModificationStamps();
+	uint modificationStamp = scene->index.AdvanceModificationCount();
+
 	int noTotalEntries = globalCache->noTotalEntries;
 	
 	int noNeededEntries = 0;
@@ -153,6 +160,7 @@ void ITMSwappingEngine_CPU<TVoxel, ITMVoxelBlockHash>::SaveToGlobalMemory(ITMSce
 				noAllocatedVoxelEntries++;
 				voxelAllocationList[vbaIdx + 1] = localPtr;
 				hashTable[entryDestId].ptr = -1;
+				modificationStamps[entryDestId] = modificationStamp;
 
 				for (int i = 0; i < SDF_BLOCK_SIZE3; i++) localVBALocation[i] = TVoxel();
 			}
@@ -184,6 +192,9 @@ void ITMSwappingEngine_CPU<TVoxel, ITMVoxelBlockHash>::CleanLocalMemory(ITMScene
 	TVoxel *localVBA = scene->localVBA.GetVoxelBlocks();
 	int *voxelAllocationList = scene->localVBA.GetAllocationList();
 
+	uint *modificationStamps = scene->index.GetModificationStamps();
+	uint modificationStamp = scene->index.AdvanceModificationCount();
+
 	int noTotalEntries = scene->index.noTotalEntries;
 
 	int noNeededEntries = 0;
@@ -205,6 +216,7 @@ void ITMSwappingEngine_CPU<TVoxel, ITMVoxelBlockHash>::CleanLocalMemory(ITMScene
 				noAllocatedVoxelEntries++;
 				voxelAllocationList[vbaIdx + 1] = localPtr;
 				hashTable[entryDestId].ptr = -1;
+				modificationStamps[entryDestId] = modificationStamp;
 
 				for (int i = 0; i < SDF_BLOCK_SIZE3; i++) localVBALocation[i] = TVoxel();
 			}
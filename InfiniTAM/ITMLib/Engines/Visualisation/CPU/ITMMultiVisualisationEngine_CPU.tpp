@@ -7,6 +7,9 @@
 
 #include "../Shared/ITMVisualisationEngine_Shared.h"
 
+#include <climits>
+#include <vector>
+
 using namespace ITMLib;
 
 template<class TVoxel, class TIndex>
@@ -21,6 +24,52 @@ void ITMMultiVisualisationEngine_CPU<TVoxel, TIndex>::PrepareRenderState(const I
 	ITMRenderStateMultiScene<TVoxel, TIndex> *state = (ITMRenderStateMultiScene<TVoxel, TIndex>*)_state;
 
 	state->PrepareLocalMaps(mapManager);
+
+	for (int localMapId = 0; localMapId < state->indexData_host.numLocalMaps; ++localMapId)
+	{
+		ITMScene<TVoxel, TIndex> *scene = mapManager.getLocalMap(localMapId)->scene;
+		Vector3s &boundsMin = state->localMapBounds_min[localMapId], &boundsMax = state->localMapBounds_max[localMapId];
+
+		// the allocation grows the bounds of each local map as it goes, they are only unknown after e.g. a load
+		if (scene->index.GetAllocationBounds(boundsMin, boundsMax)) continue;
+
+		boundsMin = Vector3s((short)SHRT_MAX); boundsMax = Vector3s((short)SHRT_MIN);
+		const ITMHashEntry *hashTable = scene->index.GetEntries();
+		int noTotalEntries = scene->index.noTotalEntries;
+
+		// each thread finds the bounds of its own entries, and these are merged at the end
+#ifdef WITH_OPENMP
+		#pragma omp parallel
+#endif
+		{
+			Vector3s boundsMin_local((short)SHRT_MAX), boundsMax_local((short)SHRT_MIN);
+
+#ifdef WITH_OPENMP
+			#pragma omp for
+#endif
+			for (int entryId = 0; entryId < noTotalEntries; ++entryId)
+			{
+				// swapped out entries count as well, as they may be swapped in without being allocated again
+				const ITMHashEntry &hashEntry = hashTable[entryId];
+				if (hashEntry.ptr < -1) continue;
+
+				boundsMin_local.x = MIN(boundsMin_local.x, hashEntry.pos.x); boundsMax_local.x = MAX(boundsMax_local.x, hashEntry.pos.x);
+				boundsMin_local.y = MIN(boundsMin_local.y, hashEntry.pos.y); boundsMax_local.y = MAX(boundsMax_local.y, hashEntry.pos.y);
+				boundsMin_local.z = MIN(boundsMin_local.z, hashEntry.pos.z); boundsMax_local.z = MAX(boundsMax_local.z, hashEntry.pos.z);
+			}
+
+#ifdef WITH_OPENMP
+			#pragma omp critical
+#endif
+			{
+				boundsMin.x = MIN(boundsMin.x, boundsMin_local.x); boundsMax.x = MAX(boundsMax.x, boundsMax_local.x);
+				boundsMin.y = MIN(boundsMin.y, boundsMin_local.y); boundsMax.y = MAX(boundsMax.y, boundsMax_local.y);
+				boundsMin.z = MIN(boundsMin.z, boundsMin_local.z); boundsMax.z = MAX(boundsMax.z, boundsMax_local.z);
+			}
+		}
+
+		scene->index.SetAllocationBounds(boundsMin, boundsMax);
+	}
 }
 
 template<class TVoxel, class TIndex>
@@ -39,52 +88,71 @@ void ITMMultiVisualisationEngine_CPU<TVoxel, TIndex>::CreateExpectedDepths(const
 		pixel.y = VERY_CLOSE;
 	}
 
-	// add the values from each local map
-	for (int localMapId = 0; localMapId < renderState->indexData_host.numLocalMaps; ++localMapId) 
-	{
-		float voxelSize = renderState->sceneParams.voxelSize;
-		const ITMHashEntry *hash_entries = renderState->indexData_host.index[localMapId];
-		int noHashEntries = ITMVoxelBlockHash::noTotalEntries;
+	float voxelSize = renderState->sceneParams.voxelSize;
+	Vector4f projParams = intrinsics->projectionParamsSimple.all;
+	Vector2f viewFrustum_minmax(renderState->sceneParams.viewFrustum_min, renderState->sceneParams.viewFrustum_max);
 
-		std::vector<RenderingBlock> renderingBlocks(MAX_RENDERING_BLOCKS);
-		int numRenderingBlocks = 0;
+	// only local maps whose bounding box intersects the view frustum contribute
+	std::vector<int> visibleLocalMaps;
+	std::vector<Matrix4f> localPoses;
+	for (int localMapId = 0; localMapId < renderState->indexData_host.numLocalMaps; ++localMapId)
+	{
+		const Vector3s &boundsMin = renderState->localMapBounds_min[localMapId], &boundsMax = renderState->localMapBounds_max[localMapId];
+		if (boundsMin.x > boundsMax.x) continue;
 
 		Matrix4f localPose = pose->GetM() * renderState->indexData_host.posesInv[localMapId];
-		for (int blockNo = 0; blockNo < noHashEntries; ++blockNo) {
-			const ITMHashEntry & blockData(hash_entries[blockNo]);
+		if (!IsBlockBoxInFrustum(boundsMin, boundsMax, localPose, projParams, imgSize, voxelSize, viewFrustum_minmax)) continue;
+
+		visibleLocalMaps.push_back(localMapId);
+		localPoses.push_back(localPose);
+	}
+
+	// the raycast only reads the min max image at the subsampled resolution
+	Vector2i rangeSize((imgSize.x - 1) / minmaximg_subsample + 1, (imgSize.y - 1) / minmaximg_subsample + 1);
+	int noHashEntries = ITMVoxelBlockHash::noTotalEntries;
+	int noTotalBlocks = (int)visibleLocalMaps.size() * noHashEntries;
+
+	// project the blocks of all visible local maps in parallel, each thread
+	// collects its own min max image, and these are merged at the end
+#ifdef WITH_OPENMP
+	#pragma omp parallel
+#endif
+	{
+		std::vector<Vector2f> minmaxData_local(rangeSize.x * rangeSize.y, Vector2f(FAR_AWAY, VERY_CLOSE));
+
+#ifdef WITH_OPENMP
+		#pragma omp for
+#endif
+		for (int blockId = 0; blockId < noTotalBlocks; ++blockId)
+		{
+			int mapNo = blockId / noHashEntries;
+			const ITMHashEntry & blockData(renderState->indexData_host.index[visibleLocalMaps[mapNo]][blockId - mapNo * noHashEntries]);
+			if (blockData.ptr < 0) continue;
 
 			Vector2i upperLeft, lowerRight;
 			Vector2f zRange;
-			bool validProjection = false;
-			if (blockData.ptr >= 0) {
-				validProjection = ProjectSingleBlock(blockData.pos, localPose, intrinsics->projectionParamsSimple.all, imgSize, voxelSize, upperLeft, lowerRight, zRange);
-			}
-			if (!validProjection) continue;
-
-			Vector2i requiredRenderingBlocks((int)ceilf((float)(lowerRight.x - upperLeft.x + 1) / (float)renderingBlockSizeX),
-				(int)ceilf((float)(lowerRight.y - upperLeft.y + 1) / (float)renderingBlockSizeY));
-			int requiredNumBlocks = requiredRenderingBlocks.x * requiredRenderingBlocks.y;
+			if (!ProjectSingleBlock(blockData.pos, localPoses[mapNo], projParams, imgSize, voxelSize, upperLeft, lowerRight, zRange)) continue;
 
-			if (numRenderingBlocks + requiredNumBlocks >= MAX_RENDERING_BLOCKS) continue;
-			int offset = numRenderingBlocks;
-			numRenderingBlocks += requiredNumBlocks;
+			if (lowerRight.x >= rangeSize.x) lowerRight.x = rangeSize.x - 1;
+			if (lowerRight.y >= rangeSize.y) lowerRight.y = rangeSize.y - 1;
 
-			CreateRenderingBlocks(&(renderingBlocks[0]), offset, upperLeft, lowerRight, zRange);
+			for (int y = upperLeft.y; y <= lowerRight.y; ++y) for (int x = upperLeft.x; x <= lowerRight.x; ++x)
+			{
+				Vector2f & pixel(minmaxData_local[x + y * rangeSize.x]);
+				if (pixel.x > zRange.x) pixel.x = zRange.x;
+				if (pixel.y < zRange.y) pixel.y = zRange.y;
+			}
 		}
 
-		// go through rendering blocks
-		for (int blockNo = 0; blockNo < numRenderingBlocks; ++blockNo) 
+#ifdef WITH_OPENMP
+		#pragma omp critical
+#endif
+		for (int y = 0; y < rangeSize.y; ++y) for (int x = 0; x < rangeSize.x; ++x)
 		{
-			// fill minmaxData
-			const RenderingBlock & b(renderingBlocks[blockNo]);
-
-			for (int y = b.upperLeft.y; y <= b.lowerRight.y; ++y) {
-				for (int x = b.upperLeft.x; x <= b.lowerRight.x; ++x) {
-					Vector2f & pixel(minmaxData[x + y*imgSize.x]);
-					if (pixel.x > b.zRange.x) pixel.x = b.zRange.x;
-					if (pixel.y < b.zRange.y) pixel.y = b.zRange.y;
-				}
-			}
+			const Vector2f & pixel_local(minmaxData_local[x + y * rangeSize.x]);
+			Vector2f & pixel(minmaxData[x + y * imgSize.x]);
+			if (pixel.x > pixel_local.x) pixel.x = pixel_local.x;
+			if (pixel.y < pixel_local.y) pixel.y = pixel_local.y;
 		}
 	}
 }
@@ -101,7 +169,7 @@ void ITMMultiVisualisationEngine_CPU<TVoxel, TIndex>::RenderImage(const ORUtils:
 	float voxelSize = renderState->sceneParams.voxelSize;
 	{
 		Vector4f projParams = intrinsics->projectionParamsSimple.all;
-		Vector4f invProjParams = InvertProjectionParams(projParams);
+		const Vector4f *rayDirections = renderState->GetRayDirections(projParams, imgSize);
 
 		const Vector2f *minmaximg = renderState->renderingRangeImage->GetData(MEMORYDEVICE_CPU);
 		float mu = renderState->sceneParams.mu;
@@ -120,7 +188,7 @@ void ITMMultiVisualisationEngine_CPU<TVoxel, TIndex>::RenderImage(const ORUtils:
 			int x = locId - y*imgSize.x;
 			int locId2 = (int)floor((float)x / minmaximg_subsample) + (int)floor((float)y / minmaximg_subsample) * imgSize.x;
 
-			castRay<VD, ID, false>(pointsRay[locId], NULL, x, y, &renderState->voxelData_host, &renderState->indexData_host, invM, invProjParams, oneOverVoxelSize, mu, minmaximg[locId2]);
+			castRay<VD, ID, false>(pointsRay[locId], NULL, rayDirections[locId], &renderState->voxelData_host, &renderState->indexData_host, invM, oneOverVoxelSize, mu, minmaximg[locId2]);
 		}
 	}
 
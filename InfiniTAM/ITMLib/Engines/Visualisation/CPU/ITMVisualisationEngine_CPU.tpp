@@ -75,6 +75,50 @@ void ITMVisualisationEngine_CPU<TVoxel,ITMVoxelBlockHash>::FindVisibleBlocks(con
 	renderState_vh->noVisibleEntries = noVisibleEntries;
 }
 
+template<class TVoxel, class TIndex>
+void ITMVisualisationEngine_CPU<TVoxel, TIndex>::FindVisibleBlocks(const ITMScene<TVoxel,TIndex> *scene, const ORUtils::SE3Pose *poses, int noPoses, const ITMIntrinsics *intrinsics,
+	ITMRenderState *renderState) const
+{
+}
+
+template<class TVoxel>
+void ITMVisualisationEngine_CPU<TVoxel,ITMVoxelBlockHash>::FindVisibleBlocks(const ITMScene<TVoxel,ITMVoxelBlockHash> *scene, const ORUtils::SE3Pose *poses, int noPoses,
+	const ITMIntrinsics *intrinsics, ITMRenderState *renderState) const
+{
+	const ITMHashEntry *hashTable = scene->index.GetEntries();
+	int noTotalEntries = scene->index.noTotalEntries;
+	float voxelSize = scene->sceneParams->voxelSize;
+	Vector2i imgSize = renderState->renderingRangeImage->noDims;
+
+	std::vector<Matrix4f> M(noPoses);
+	for (int poseIdx = 0; poseIdx < noPoses; ++poseIdx) M[poseIdx] = poses[poseIdx].GetM();
+	Vector4f projParams = intrinsics->projectionParamsSimple.all;
+
+	ITMRenderState_VH *renderState_vh = (ITMRenderState_VH*)renderState;
+
+	int noVisibleEntries = 0;
+	int *visibleEntryIDs = renderState_vh->GetVisibleEntryIDs();
+
+	//build visible list, an entry is kept if any of the poses can see it
+	for (int targetIdx = 0; targetIdx < noTotalEntries; targetIdx++)
+	{
+		const ITMHashEntry &hashEntry = hashTable[targetIdx];
+		if (hashEntry.ptr < 0) continue;
+
+		bool isVisible = false, isVisibleEnlarged;
+		for (int poseIdx = 0; poseIdx < noPoses && !isVisible; ++poseIdx)
+			checkBlockVisibility<false>(isVisible, isVisibleEnlarged, hashEntry.pos, M[poseIdx], projParams, voxelSize, imgSize);
+
+		if (isVisible)
+		{
+			visibleEntryIDs[noVisibleEntries] = targetIdx;
+			noVisibleEntries++;
+		}
+	}
+
+	renderState_vh->noVisibleEntries = noVisibleEntries;
+}
+
 template<class TVoxel, class TIndex>
 int ITMVisualisationEngine_CPU<TVoxel, TIndex>::CountVisibleBlocks(const ITMScene<TVoxel,TIndex> *scene, const ITMRenderState *renderState, int minBlockId, int maxBlockId) const
 {
@@ -187,6 +231,7 @@ static void GenericRaycast(const ITMScene<TVoxel, TIndex> *scene, const Vector2i
 	{
 		entriesVisibleType = ((ITMRenderState_VH*)renderState)->GetEntriesVisibleType();
 	}
+	const Vector4f *rayDirections = renderState->GetRayDirections(projParams, imgSize);
 
 #ifdef WITH_OPENMP
 	#pragma omp parallel for
@@ -200,11 +245,10 @@ static void GenericRaycast(const ITMScene<TVoxel, TIndex> *scene, const Vector2i
 		if (entriesVisibleType!=NULL) castRay<TVoxel, TIndex, true>(
 				pointsRay[locId],
 				entriesVisibleType,
-				x, y,
+				rayDirections[locId],
 				voxelData,
 				voxelIndex,
 				invM,
-				InvertProjectionParams(projParams),
 				oneOverVoxelSize,
 				mu,
 				minmaximg[locId2]
@@ -212,11 +256,10 @@ static void GenericRaycast(const ITMScene<TVoxel, TIndex> *scene, const Vector2i
 		else castRay<TVoxel, TIndex, false>(
 				pointsRay[locId],
 				NULL,
-				x, y,
+				rayDirections[locId],
 				voxelData,
 				voxelIndex,
 				invM,
-				InvertProjectionParams(projParams),
 				oneOverVoxelSize,
 				mu,
 				minmaximg[locId2]
@@ -224,6 +267,65 @@ static void GenericRaycast(const ITMScene<TVoxel, TIndex> *scene, const Vector2i
 	}
 }
 
+template<class TVoxel, class TIndex>
+static void GenericRaycastSubsampled(const ITMScene<TVoxel, TIndex> *scene, const Vector2i& imgSize, const Matrix4f& invM, const Vector4f& projParams, ITMRenderState *renderState, int subsample)
+{
+	const Vector2f *minmaximg = renderState->renderingRangeImage->GetData(MEMORYDEVICE_CPU);
+	float mu = scene->sceneParams->mu;
+	float voxelSize = scene->sceneParams->voxelSize;
+	float oneOverVoxelSize = 1.0f / voxelSize;
+	Vector4f *pointsRay = renderState->raycastResult->GetData(MEMORYDEVICE_CPU);
+	const TVoxel *voxelData = scene->localVBA.GetVoxelBlocks();
+	const typename ITMVoxelBlockHash::IndexData *voxelIndex = scene->index.getIndexData();
+	uchar *entriesVisibleType = NULL;
+	if (dynamic_cast<const ITMRenderState_VH*>(renderState) != NULL)
+	{
+		entriesVisibleType = ((ITMRenderState_VH*)renderState)->GetEntriesVisibleType();
+	}
+
+	Matrix4f M; invM.inv(M);
+	const Vector4f *rayDirections = renderState->GetRayDirections(projParams, imgSize);
+	Vector2i noSamples(noRaycastSamples(imgSize.x, subsample), noRaycastSamples(imgSize.y, subsample));
+
+	// first pass: cast the rays of the sparse sample grid
+#ifdef WITH_OPENMP
+	#pragma omp parallel for
+#endif
+	for (int sampleId = 0; sampleId < noSamples.x * noSamples.y; ++sampleId)
+	{
+		int sy = sampleId / noSamples.x;
+		int x = raycastSampleCoord(sampleId - sy * noSamples.x, subsample, imgSize.x);
+		int y = raycastSampleCoord(sy, subsample, imgSize.y);
+		int locId2 = (int)floor((float)x / minmaximg_subsample) + (int)floor((float)y / minmaximg_subsample) * imgSize.x;
+
+		int locId = x + y * imgSize.x;
+		if (entriesVisibleType != NULL) castRay<TVoxel, TIndex, true>(pointsRay[locId], entriesVisibleType, rayDirections[locId],
+			voxelData, voxelIndex, invM, oneOverVoxelSize, mu, minmaximg[locId2]);
+		else castRay<TVoxel, TIndex, false>(pointsRay[locId], NULL, rayDirections[locId],
+			voxelData, voxelIndex, invM, oneOverVoxelSize, mu, minmaximg[locId2]);
+	}
+
+	// second pass: interpolate the remaining pixels, casting their own rays only near depth discontinuities and holes
+#ifdef WITH_OPENMP
+	#pragma omp parallel for
+#endif
+	for (int locId = 0; locId < imgSize.x * imgSize.y; ++locId)
+	{
+		int y = locId / imgSize.x;
+		int x = locId - y * imgSize.x;
+
+		if (isRaycastSample(x, y, imgSize, subsample)) continue;
+		if (interpolateRaycastSample(pointsRay[locId], x, y, pointsRay, imgSize, subsample, M, voxelSize)) continue;
+
+		int locId2 = (int)floor((float)x / minmaximg_subsample) + (int)floor((float)y / minmaximg_subsample) * imgSize.x;
+
+		if (entriesVisibleType != NULL) castRay<TVoxel, TIndex, true>(pointsRay[locId], entriesVisibleType, rayDirections[locId],
+			voxelData, voxelIndex, invM, oneOverVoxelSize, mu, minmaximg[locId2]);
+		else castRay<TVoxel, TIndex, false>(pointsRay[locId], NULL, rayDirections[locId],
+			voxelData, voxelIndex, invM, oneOverVoxelSize, mu, minmaximg[locId2]);
+	}
+}
+
 
 template<class TVoxel, class TIndex>
 static void RenderImage_common(const ITMScene<TVoxel,TIndex> *scene, const ORUtils::SE3Pose *pose, const ITMIntrinsics *intrinsics,
@@ -345,14 +447,16 @@ static void CreatePointCloud_common(const ITMScene<TVoxel,TIndex> *scene, const
 }
 
 template<class TVoxel, class TIndex>
-static void CreateICPMaps_common(const ITMScene<TVoxel,TIndex> *scene, const ITMView *view, ITMTrackingState *trackingState, ITMRenderState *renderState)
+static void CreateICPMaps_common(const ITMScene<TVoxel,TIndex> *scene, const ITMView *view, ITMTrackingState *trackingState, ITMRenderState *renderState,
+	int raycastSubsample)
 {
 	Vector2i imgSize = renderState->raycastResult->noDims;
 	Matrix4f invM = trackingState->pose_d->GetInvM();
 
 	// this one is generally done for the ICP tracker, so yes, update
 	// the list of visible blocks if possible
-	GenericRaycast(scene, imgSize, invM, view->calib.intrinsics_d.projectionParamsSimple.all, renderState, true);
+	if (raycastSubsample > 1) GenericRaycastSubsampled(scene, imgSize, invM, view->calib.intrinsics_d.projectionParamsSimple.all, renderState, raycastSubsample);
+	else GenericRaycast(scene, imgSize, invM, view->calib.intrinsics_d.projectionParamsSimple.all, renderState, true);
 	trackingState->pose_pointCloud->SetFrom(trackingState->pose_d);
 
 	Vector3f lightSource = -Vector3f(invM.getColumn(2));
@@ -425,7 +529,7 @@ static void ForwardRender_common(const ITMScene<TVoxel, TIndex> *scene, const IT
 	}
 
 	renderState->noFwdProjMissingPoints = noMissingPoints;
-	const Vector4f invProjParams = InvertProjectionParams(projParams);
+	const Vector4f *rayDirections = renderState->GetRayDirections(projParams, imgSize);
     
 	for (int pointId = 0; pointId < noMissingPoints; pointId++)
 	{
@@ -433,7 +537,7 @@ static void ForwardRender_common(const ITMScene<TVoxel, TIndex> *scene, const IT
 		int y = locId / imgSize.x, x = locId - y*imgSize.x;
 		int locId2 = (int)floor((float)x / minmaximg_subsample) + (int)floor((float)y / minmaximg_subsample) * imgSize.x;
 
-		castRay<TVoxel, TIndex, false>(forwardProjection[locId], NULL, x, y, voxelData, voxelIndex, invM, invProjParams,
+		castRay<TVoxel, TIndex, false>(forwardProjection[locId], NULL, rayDirections[locId], voxelData, voxelIndex, invM,
 			1.0f / scene->sceneParams->voxelSize, scene->sceneParams->mu, minmaximg[locId2]);
 	}
 }
@@ -486,16 +590,17 @@ void ITMVisualisationEngine_CPU<TVoxel,ITMVoxelBlockHash>::CreatePointCloud(cons
 }
 
 template<class TVoxel, class TIndex>
-void ITMVisualisationEngine_CPU<TVoxel,TIndex>::CreateICPMaps(const ITMScene<TVoxel,TIndex> *scene, const ITMView *view, ITMTrackingState *trackingState, ITMRenderState *renderState) const
+void ITMVisualisationEngine_CPU<TVoxel,TIndex>::CreateICPMaps(const ITMScene<TVoxel,TIndex> *scene, const ITMView *view, ITMTrackingState *trackingState, ITMRenderState *renderState,
+	int raycastSubsample) const
 {
-	CreateICPMaps_common(scene, view, trackingState, renderState);
+	CreateICPMaps_common(scene, view, trackingState, renderState, raycastSubsample);
 }
 
 template<class TVoxel>
 void ITMVisualisationEngine_CPU<TVoxel,ITMVoxelBlockHash>::CreateICPMaps(const ITMScene<TVoxel,ITMVoxelBlockHash> *scene, const ITMView *view, ITMTrackingState *trackingState, 
-	ITMRenderState *renderState) const
+	ITMRenderState *renderState, int raycastSubsample) const
 {
-	CreateICPMaps_common(scene, view, trackingState, renderState);
+	CreateICPMaps_common(scene, view, trackingState, renderState, raycastSubsample);
 }
 
 template<class TVoxel, class TIndex>
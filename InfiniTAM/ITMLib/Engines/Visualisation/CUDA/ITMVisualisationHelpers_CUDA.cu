@@ -51,6 +51,37 @@ __global__ void ITMLib::buildCompleteVisibleList_device(const ITMHashEntry *hash
 	}
 }
 
+__global__ void ITMLib::buildCompleteVisibleListMultiPose_device(const ITMHashEntry *hashTable, int noTotalEntries, int *visibleEntryIDs, int *noVisibleEntries,
+	const Matrix4f *M, int noPoses, Vector4f projParams, Vector2i imgSize, float voxelSize)
+{
+	int targetIdx = threadIdx.x + blockIdx.x * blockDim.x;
+	if (targetIdx > noTotalEntries - 1) return;
+
+	__shared__ bool shouldPrefix;
+
+	bool isVisible = false, isVisibleEnlarged;
+	const ITMHashEntry &hashEntry = hashTable[targetIdx];
+
+	shouldPrefix = false;
+	__syncthreads();
+
+	if (hashEntry.ptr >= 0)
+	{
+		shouldPrefix = true;
+
+		for (int poseIdx = 0; poseIdx < noPoses && !isVisible; ++poseIdx)
+			checkBlockVisibility<false>(isVisible, isVisibleEnlarged, hashEntry.pos, M[poseIdx], projParams, voxelSize, imgSize);
+	}
+
+	__syncthreads();
+
+	if (shouldPrefix)
+	{
+		int offset = computePrefixSum_device<int>(isVisible, noVisibleEntries, blockDim.x * blockDim.y, threadIdx.x);
+		if (offset != -1) visibleEntryIDs[offset] = targetIdx;
+	}
+}
+
 __global__ void ITMLib::projectAndSplitBlocks_device(const ITMHashEntry *hashEntries, const int *visibleEntryIDs, int noVisibleEntries,
 	const Matrix4f pose_M, const Vector4f intrinsics, const Vector2i imgSize, float voxelSize, RenderingBlock *renderingBlocks,
 	uint *noTotalBlocks)
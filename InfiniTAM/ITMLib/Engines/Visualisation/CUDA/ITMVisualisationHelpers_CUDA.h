@@ -16,6 +16,9 @@ namespace ITMLib
 	__global__ void buildCompleteVisibleList_device(const ITMHashEntry *hashTable, /*ITMHashCacheState *cacheStates, bool useSwapping,*/ int noTotalEntries,
 		int *visibleEntryIDs, int *noVisibleEntries, uchar *entriesVisibleType, Matrix4f M, Vector4f projParams, Vector2i imgSize, float voxelSize);
 
+	__global__ void buildCompleteVisibleListMultiPose_device(const ITMHashEntry *hashTable, int noTotalEntries, int *visibleEntryIDs, int *noVisibleEntries,
+		const Matrix4f *M, int noPoses, Vector4f projParams, Vector2i imgSize, float voxelSize);
+
 	__global__ void countVisibleBlocks_device(const int *visibleEntryIDs, int noVisibleEntries, const ITMHashEntry *hashTable, uint *noBlocks, int minBlockId, int maxBlockId);
 
 	__global__ void projectAndSplitBlocks_device(const ITMHashEntry *hashEntries, const int *visibleEntryIDs, int noVisibleEntries,
@@ -37,7 +40,7 @@ namespace ITMLib
 
 	template<class TVoxel, class TIndex, bool modifyVisibleEntries>
 	__global__ void genericRaycast_device(Vector4f *out_ptsRay, uchar *entriesVisibleType, const TVoxel *voxelData,
-		const typename TIndex::IndexData *voxelIndex, Vector2i imgSize, Matrix4f invM, Vector4f invProjParams,
+		const typename TIndex::IndexData *voxelIndex, Vector2i imgSize, Matrix4f invM, const Vector4f *rayDirections,
 		float oneOverVoxelSize, const Vector2f *minmaximg, float mu)
 	{
 		int x = (threadIdx.x + blockIdx.x * blockDim.x), y = (threadIdx.y + blockIdx.y * blockDim.y);
@@ -47,12 +50,46 @@ namespace ITMLib
 		int locId = x + y * imgSize.x;
 		int locId2 = (int)floor((float)x / minmaximg_subsample) + (int)floor((float)y / minmaximg_subsample) * imgSize.x;
 
-		castRay<TVoxel, TIndex, modifyVisibleEntries>(out_ptsRay[locId], entriesVisibleType, x, y, voxelData, voxelIndex, invM, invProjParams, oneOverVoxelSize, mu, minmaximg[locId2]);
+		castRay<TVoxel, TIndex, modifyVisibleEntries>(out_ptsRay[locId], entriesVisibleType, rayDirections[locId], voxelData, voxelIndex, invM, oneOverVoxelSize, mu, minmaximg[locId2]);
+	}
+
+	template<class TVoxel, class TIndex, bool modifyVisibleEntries>
+	__global__ void genericRaycastSamples_device(Vector4f *out_ptsRay, uchar *entriesVisibleType, const TVoxel *voxelData,
+		const typename TIndex::IndexData *voxelIndex, Vector2i imgSize, Vector2i noSamples, int subsample, Matrix4f invM, const Vector4f *rayDirections,
+		float oneOverVoxelSize, const Vector2f *minmaximg, float mu)
+	{
+		int sx = (threadIdx.x + blockIdx.x * blockDim.x), sy = (threadIdx.y + blockIdx.y * blockDim.y);
+
+		if (sx >= noSamples.x || sy >= noSamples.y) return;
+
+		int x = raycastSampleCoord(sx, subsample, imgSize.x), y = raycastSampleCoord(sy, subsample, imgSize.y);
+		int locId = x + y * imgSize.x;
+		int locId2 = (int)floor((float)x / minmaximg_subsample) + (int)floor((float)y / minmaximg_subsample) * imgSize.x;
+
+		castRay<TVoxel, TIndex, modifyVisibleEntries>(out_ptsRay[locId], entriesVisibleType, rayDirections[locId], voxelData, voxelIndex, invM, oneOverVoxelSize, mu, minmaximg[locId2]);
+	}
+
+	template<class TVoxel, class TIndex, bool modifyVisibleEntries>
+	__global__ void fillRaycastSamples_device(Vector4f *ptsRay, uchar *entriesVisibleType, const TVoxel *voxelData,
+		const typename TIndex::IndexData *voxelIndex, Vector2i imgSize, int subsample, Matrix4f M, Matrix4f invM, const Vector4f *rayDirections,
+		float voxelSize, const Vector2f *minmaximg, float mu)
+	{
+		int x = (threadIdx.x + blockIdx.x * blockDim.x), y = (threadIdx.y + blockIdx.y * blockDim.y);
+
+		if (x >= imgSize.x || y >= imgSize.y) return;
+		if (isRaycastSample(x, y, imgSize, subsample)) return;
+
+		int locId = x + y * imgSize.x;
+		if (interpolateRaycastSample(ptsRay[locId], x, y, ptsRay, imgSize, subsample, M, voxelSize)) return;
+
+		int locId2 = (int)floor((float)x / minmaximg_subsample) + (int)floor((float)y / minmaximg_subsample) * imgSize.x;
+
+		castRay<TVoxel, TIndex, modifyVisibleEntries>(ptsRay[locId], entriesVisibleType, rayDirections[locId], voxelData, voxelIndex, invM, 1.0f / voxelSize, mu, minmaximg[locId2]);
 	}
 
 	template<class TVoxel, class TIndex, bool modifyVisibleEntries>
 	__global__ void genericRaycastMissingPoints_device(Vector4f *forwardProjection, uchar *entriesVisibleType, const TVoxel *voxelData,
-		const typename TIndex::IndexData *voxelIndex, Vector2i imgSize, Matrix4f invM, Vector4f invProjParams, float oneOverVoxelSize,
+		const typename TIndex::IndexData *voxelIndex, Vector2i imgSize, Matrix4f invM, const Vector4f *rayDirections, float oneOverVoxelSize,
 		int *fwdProjMissingPoints, int noMissingPoints, const Vector2f *minmaximg, float mu)
 	{
 		int pointId = threadIdx.x + blockIdx.x * blockDim.x;
@@ -63,7 +100,7 @@ namespace ITMLib
 		int y = locId / imgSize.x, x = locId - y*imgSize.x;
 		int locId2 = (int)floor((float)x / minmaximg_subsample) + (int)floor((float)y / minmaximg_subsample) * imgSize.x;
 
-		castRay<TVoxel, TIndex, modifyVisibleEntries>(forwardProjection[locId], entriesVisibleType, x, y, voxelData, voxelIndex, invM, invProjParams, oneOverVoxelSize, mu, minmaximg[locId2]);
+		castRay<TVoxel, TIndex, modifyVisibleEntries>(forwardProjection[locId], entriesVisibleType, rayDirections[locId], voxelData, voxelIndex, invM, oneOverVoxelSize, mu, minmaximg[locId2]);
 	}
 
 	template<bool flipNormals>
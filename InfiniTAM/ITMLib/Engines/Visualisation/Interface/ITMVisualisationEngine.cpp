@@ -104,3 +104,24 @@ void IITMVisualisationEngine::WeightToUchar4(ITMUChar4Image *dst, const ITMFloat
 		}
 	}
 }
+
+void IITMVisualisationEngine::RaycastToDepth(ITMFloatImage *dst, const ITMFloat4Image *src, const Matrix4f & M, float voxelSize)
+{
+	float *dest = dst->GetData(MEMORYDEVICE_CPU);
+	const Vector4f *source = src->GetData(MEMORYDEVICE_CPU);
+	int dataSize = static_cast<int>(dst->dataSize);
+
+#ifdef WITH_OPENMP
+	#pragma omp parallel for
+#endif
+	for (int idx = 0; idx < dataSize; idx++)
+	{
+		Vector4f sourceVal = source[idx];
+		if (sourceVal.w > 0.0f)
+		{
+			Vector4f pt(sourceVal.x * voxelSize, sourceVal.y * voxelSize, sourceVal.z * voxelSize, 1.0f);
+			dest[idx] = (M * pt).z;
+		}
+		else dest[idx] = -1.0f;
+	}
+}
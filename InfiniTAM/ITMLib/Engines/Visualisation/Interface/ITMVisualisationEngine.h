@@ -33,6 +33,12 @@ namespace ITMLib
 		static void DepthToUchar4(ITMUChar4Image *dst, const ITMFloatImage *src);
 		static void NormalToUchar4(ITMUChar4Image* dst, const ITMFloat4Image *src);
 		static void WeightToUchar4(ITMUChar4Image *dst, const ITMFloatImage *src);
+
+		/** Converts the raycast result (points in voxel coordinates) to a
+		depth image in metres, as seen from a camera with pose @p M.
+		Pixels without a surface are set to -1.
+		*/
+		static void RaycastToDepth(ITMFloatImage *dst, const ITMFloat4Image *src, const Matrix4f & M, float voxelSize);
 	};
 
 	template<class TIndex> struct IndexToRenderState { typedef ITMRenderState type; };
@@ -67,6 +73,14 @@ namespace ITMLib
 		virtual void FindVisibleBlocks(const ITMScene<TVoxel,TIndex> *scene, const ORUtils::SE3Pose *pose, const ITMIntrinsics *intrinsics,
 			ITMRenderState *renderState) const = 0;
 
+		/** Given a scene, a set of poses and intrinsics shared by
+		all of them, compute the union of the visible subsets of the
+		scene in a single pass over the index. This allows batched
+		rendering of nearby views to share one visible list.
+		*/
+		virtual void FindVisibleBlocks(const ITMScene<TVoxel,TIndex> *scene, const ORUtils::SE3Pose *poses, int noPoses, const ITMIntrinsics *intrinsics,
+			ITMRenderState *renderState) const = 0;
+
 		/** Given a render state, Count the number of visible blocks
 		with minBlockId <= blockID <= maxBlockId .
 		*/
@@ -95,9 +109,13 @@ namespace ITMLib
 
 		/** Create an image of reference points and normals as
 		required by the ITMLib::Engine::ITMDepthTracker classes.
+
+		If @p raycastSubsample is larger than 1, only every
+		raycastSubsample-th ray is cast and the other pixels are
+		interpolated, except near depth discontinuities.
 		*/
 		virtual void CreateICPMaps(const ITMScene<TVoxel,TIndex> *scene, const ITMView *view, ITMTrackingState *trackingState, 
-			ITMRenderState *renderState) const = 0;
+			ITMRenderState *renderState, int raycastSubsample) const = 0;
 
 		/** Create an image of reference points and normals as
 		required by the ITMLib::Engine::ITMDepthTracker classes.
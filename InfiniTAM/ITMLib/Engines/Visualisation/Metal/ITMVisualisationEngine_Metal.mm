@@ -207,9 +207,12 @@ static void RenderImage_common_metal(const ITMScene<TVoxel,ITMVoxelBlockHash> *s
 }
 
 template<class TVoxel>
-void ITMVisualisationEngine_Metal<TVoxel, ITMVoxelBlockHash>::CreateICPMaps(const ITMScene<TVoxel,ITMVoxelBlockHash> *scene, const ITMView *view, ITMTrackingState *trackingState, ITMRenderState *renderState) const
+void ITMVisualisationEngine_Metal<TVoxel, ITMVoxelBlockHash>::CreateICPMaps(const ITMScene<TVoxel,ITMVoxelBlockHash> *scene, const ITMView *view, ITMTrackingState *trackingState, ITMRenderState *renderState,
+    int raycastSubsample) const
 {
-    CreateICPMaps_common_metal(scene, view, trackingState, renderState);
+    // subsampled raycasting is not implemented as a Metal kernel, the CPU version works on the shared buffers
+    if (raycastSubsample > 1) ITMVisualisationEngine_CPU<TVoxel, ITMVoxelBlockHash>::CreateICPMaps(scene, view, trackingState, renderState, raycastSubsample);
+    else CreateICPMaps_common_metal(scene, view, trackingState, renderState);
 }
 
 template<class TVoxel>
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "../../../Objects/Scene/ITMRepresentationAccess.h"
+#include "../../../Utils/ITMProjectionUtils.h"
 
 static const CONSTPTR(int) MAX_RENDERING_BLOCKS = 65536*4;
 //static const int MAX_RENDERING_BLOCKS = 16384;
@@ -76,6 +77,36 @@ _CPU_AND_GPU_CODE_ inline bool ProjectSingleBlock(const THREADPTR(Vector3s) & bl
 	return true;
 }
 
+/// Conservative frustum test for an axis aligned box of blocks [blocksMin, blocksMax], given in the coordinates of pose:
+/// only returns false if all eight corners of the box are outside the same plane of the view frustum
+_CPU_AND_GPU_CODE_ inline bool IsBlockBoxInFrustum(const THREADPTR(Vector3s) & blocksMin, const THREADPTR(Vector3s) & blocksMax, const THREADPTR(Matrix4f) & pose,
+	const THREADPTR(Vector4f) & intrinsics, const THREADPTR(Vector2i) & imgSize, float voxelSize, const THREADPTR(Vector2f) & viewFrustum_minmax)
+{
+	int noOutside[6] = { 0, 0, 0, 0, 0, 0 };
+	for (int corner = 0; corner < 8; ++corner)
+	{
+		Vector3s tmp;
+		tmp.x = (corner & 1) ? blocksMax.x + 1 : blocksMin.x;
+		tmp.y = (corner & 2) ? blocksMax.y + 1 : blocksMin.y;
+		tmp.z = (corner & 4) ? blocksMax.z + 1 : blocksMin.z;
+		Vector4f pt3d(TO_FLOAT3(tmp) * (float)SDF_BLOCK_SIZE * voxelSize, 1.0f);
+		pt3d = pose * pt3d;
+
+		// u = fx * x / z + cx has to be in [0, imgSize.x], multiplied through by z > 0
+		float u = intrinsics.x * pt3d.x + intrinsics.z * pt3d.z, v = intrinsics.y * pt3d.y + intrinsics.w * pt3d.z;
+		if (pt3d.z < viewFrustum_minmax.x) noOutside[0]++;
+		if (pt3d.z > viewFrustum_minmax.y) noOutside[1]++;
+		if (u < 0.0f) noOutside[2]++;
+		if (u > (float)imgSize.x * pt3d.z) noOutside[3]++;
+		if (v < 0.0f) noOutside[4]++;
+		if (v > (float)imgSize.y * pt3d.z) noOutside[5]++;
+	}
+
+	for (int plane = 0; plane < 6; ++plane) if (noOutside[plane] == 8) return false;
+
+	return true;
+}
+
 _CPU_AND_GPU_CODE_ inline void CreateRenderingBlocks(DEVICEPTR(RenderingBlock) *renderingBlockList, int offset,
 	const THREADPTR(Vector2i) & upperLeft, const THREADPTR(Vector2i) & lowerRight, const THREADPTR(Vector2f) & zRange)
 {
@@ -98,12 +129,14 @@ _CPU_AND_GPU_CODE_ inline void CreateRenderingBlocks(DEVICEPTR(RenderingBlock) *
 
 #endif
 
+/// Cast the ray with unit direction rayDirection_camera (and distance along the ray per unit of depth in
+/// rayDirection_camera.w) as returned by computeRayDirection or ITMRenderState::GetRayDirections
 template<class TVoxel, class TIndex, bool modifyVisibleEntries>
-_CPU_AND_GPU_CODE_ inline bool castRay(DEVICEPTR(Vector4f) &pt_out, DEVICEPTR(uchar) *entriesVisibleType, 
-	int x, int y, const CONSTPTR(TVoxel) *voxelData, const CONSTPTR(typename TIndex::IndexData) *voxelIndex, 
-	Matrix4f invM, Vector4f invProjParams, float oneOverVoxelSize, float mu, const CONSTPTR(Vector2f) & viewFrustum_minmax)
+_CPU_AND_GPU_CODE_ inline bool castRay(DEVICEPTR(Vector4f) &pt_out, DEVICEPTR(uchar) *entriesVisibleType, const THREADPTR(Vector4f) & rayDirection_camera,
+	const CONSTPTR(TVoxel) *voxelData, const CONSTPTR(typename TIndex::IndexData) *voxelIndex, Matrix4f invM, float oneOverVoxelSize, float mu,
+	const CONSTPTR(Vector2f) & viewFrustum_minmax)
 {
-	Vector4f pt_camera_f; Vector3f pt_block_s, pt_block_e, rayDirection, pt_result;
+	Vector4f pt_camera_f; Vector3f pt_block_s, rayDirection, pt_result;
 	bool pt_found;
 	int vmIndex;
 	float sdfValue = 1.0f, confidence;
@@ -111,23 +144,19 @@ _CPU_AND_GPU_CODE_ inline bool castRay(DEVICEPTR(Vector4f) &pt_out, DEVICEPTR(uc
 
 	stepScale = mu * oneOverVoxelSize;
 
-	pt_camera_f.z = viewFrustum_minmax.x;
-	pt_camera_f.x = pt_camera_f.z * ((float(x) + invProjParams.z) * invProjParams.x);
-	pt_camera_f.y = pt_camera_f.z * ((float(y) + invProjParams.w) * invProjParams.y);
+	totalLength = viewFrustum_minmax.x * rayDirection_camera.w;
+	pt_camera_f.x = totalLength * rayDirection_camera.x;
+	pt_camera_f.y = totalLength * rayDirection_camera.y;
+	pt_camera_f.z = totalLength * rayDirection_camera.z;
 	pt_camera_f.w = 1.0f;
-	totalLength = length(TO_VECTOR3(pt_camera_f)) * oneOverVoxelSize;
+	totalLength *= oneOverVoxelSize;
 	pt_block_s = TO_VECTOR3(invM * pt_camera_f) * oneOverVoxelSize;
 
-	pt_camera_f.z = viewFrustum_minmax.y;
-	pt_camera_f.x = pt_camera_f.z * ((float(x) + invProjParams.z) * invProjParams.x);
-	pt_camera_f.y = pt_camera_f.z * ((float(y) + invProjParams.w) * invProjParams.y);
-	pt_camera_f.w = 1.0f;
-	totalLengthMax = length(TO_VECTOR3(pt_camera_f)) * oneOverVoxelSize;
-	pt_block_e = TO_VECTOR3(invM * pt_camera_f) * oneOverVoxelSize;
+	totalLengthMax = viewFrustum_minmax.y * rayDirection_camera.w * oneOverVoxelSize;
 
-	rayDirection = pt_block_e - pt_block_s;
-	float direction_norm = 1.0f / sqrt(rayDirection.x * rayDirection.x + rayDirection.y * rayDirection.y + rayDirection.z * rayDirection.z);
-	rayDirection *= direction_norm;
+	pt_camera_f.x = rayDirection_camera.x; pt_camera_f.y = rayDirection_camera.y; pt_camera_f.z = rayDirection_camera.z;
+	pt_camera_f.w = 0.0f;
+	rayDirection = TO_VECTOR3(invM * pt_camera_f);
 
 	pt_result = pt_block_s;
 
@@ -173,6 +202,67 @@ _CPU_AND_GPU_CODE_ inline bool castRay(DEVICEPTR(Vector4f) &pt_out, DEVICEPTR(uc
 	return pt_found;
 }
 
+template<class TVoxel, class TIndex, bool modifyVisibleEntries>
+_CPU_AND_GPU_CODE_ inline bool castRay(DEVICEPTR(Vector4f) &pt_out, DEVICEPTR(uchar) *entriesVisibleType, 
+	int x, int y, const CONSTPTR(TVoxel) *voxelData, const CONSTPTR(typename TIndex::IndexData) *voxelIndex, 
+	Matrix4f invM, Vector4f invProjParams, float oneOverVoxelSize, float mu, const CONSTPTR(Vector2f) & viewFrustum_minmax)
+{
+	Vector4f rayDirection_camera = computeRayDirection(x, y, invProjParams);
+
+	return castRay<TVoxel, TIndex, modifyVisibleEntries>(pt_out, entriesVisibleType, rayDirection_camera, voxelData, voxelIndex, invM, oneOverVoxelSize, mu, viewFrustum_minmax);
+}
+
+/// Subsampled raycasting: only every subsample-th pixel in x and y is raycast, plus the last row and column
+_CPU_AND_GPU_CODE_ inline int noRaycastSamples(int size, int subsample)
+{
+	return (size + subsample - 2) / subsample + 1;
+}
+
+_CPU_AND_GPU_CODE_ inline int raycastSampleCoord(int sampleId, int subsample, int size)
+{
+	return MIN(sampleId * subsample, size - 1);
+}
+
+_CPU_AND_GPU_CODE_ inline bool isRaycastSample(int x, int y, const THREADPTR(Vector2i) & imgSize, int subsample)
+{
+	return (x % subsample == 0 || x == imgSize.x - 1) && (y % subsample == 0 || y == imgSize.y - 1);
+}
+
+/// Fill a pixel of a subsampled raycast from the four surrounding samples. If none of them hit a surface,
+/// neither does the pixel; if all of them did, it is interpolated. Fails if only some samples are missing
+/// or if their depths differ by more than 2% per pixel of sample spacing, i.e. if the pixel is near a
+/// silhouette or depth discontinuity, in which case the ray for this pixel has to be cast explicitly.
+_CPU_AND_GPU_CODE_ inline bool interpolateRaycastSample(DEVICEPTR(Vector4f) &pt_out, int x, int y, const CONSTPTR(Vector4f) *pointsRay,
+	const THREADPTR(Vector2i) & imgSize, int subsample, const THREADPTR(Matrix4f) & M, float voxelSize)
+{
+	int x0 = (x / subsample) * subsample, y0 = (y / subsample) * subsample;
+	int x1 = MIN(x0 + subsample, imgSize.x - 1), y1 = MIN(y0 + subsample, imgSize.y - 1);
+
+	Vector4f p00 = pointsRay[x0 + y0 * imgSize.x], p10 = pointsRay[x1 + y0 * imgSize.x];
+	Vector4f p01 = pointsRay[x0 + y1 * imgSize.x], p11 = pointsRay[x1 + y1 * imgSize.x];
+	int noFound = (p00.w > 0.0f) + (p10.w > 0.0f) + (p01.w > 0.0f) + (p11.w > 0.0f);
+	if (noFound == 0)
+	{
+		pt_out = p00;
+		return true;
+	}
+	if (noFound < 4) return false;
+
+	float z00 = (M * Vector4f(p00.x * voxelSize, p00.y * voxelSize, p00.z * voxelSize, 1.0f)).z;
+	float z10 = (M * Vector4f(p10.x * voxelSize, p10.y * voxelSize, p10.z * voxelSize, 1.0f)).z;
+	float z01 = (M * Vector4f(p01.x * voxelSize, p01.y * voxelSize, p01.z * voxelSize, 1.0f)).z;
+	float z11 = (M * Vector4f(p11.x * voxelSize, p11.y * voxelSize, p11.z * voxelSize, 1.0f)).z;
+	float zMin = MIN(MIN(z00, z10), MIN(z01, z11)), zMax = MAX(MAX(z00, z10), MAX(z01, z11));
+	if (zMax - zMin > 0.02f * (float)subsample * zMin) return false;
+
+	float fx = (x1 > x0) ? (float)(x - x0) / (float)(x1 - x0) : 0.0f;
+	float fy = (y1 > y0) ? (float)(y - y0) / (float)(y1 - y0) : 0.0f;
+
+	pt_out = (p00 * (1.0f - fx) + p10 * fx) * (1.0f - fy) + (p01 * (1.0f - fx) + p11 * fx) * fy;
+
+	return true;
+}
+
 _CPU_AND_GPU_CODE_ inline int forwardProjectPixel(Vector4f pixel, const CONSTPTR(Matrix4f) &M, const CONSTPTR(Vector4f) &projParams,
 	const THREADPTR(Vector2i) &imgSize)
 {
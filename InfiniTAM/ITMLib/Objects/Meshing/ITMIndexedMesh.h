@@ -0,0 +1,166 @@
+// Copyright 2014-2017 Oxford University Innovation Limited and the authors of InfiniTAM
+
+#pragma once
+
+#include "ITMMesh.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+namespace ITMLib
+{
+	/** Triangle mesh in which triangles share their vertices by
+	    index, with optional per-vertex normals and colours.
+	*/
+	class ITMIndexedMesh
+	{
+	private:
+		struct WeldEntry
+		{
+			Vector3f p; uint cornerId;
+			bool operator<(const WeldEntry &other) const
+			{
+				if (p.x != other.p.x) return p.x < other.p.x;
+				if (p.y != other.p.y) return p.y < other.p.y;
+				if (p.z != other.p.z) return p.z < other.p.z;
+				return cornerId < other.cornerId;
+			}
+		};
+
+		static void AppendToBuffer(std::vector<char> &buffer, const void *data, size_t size)
+		{
+			const char *bytes = (const char*)data;
+			buffer.insert(buffer.end(), bytes, bytes + size);
+		}
+
+	public:
+		/// Per-vertex attributes the meshing engine should fill in, if it can
+		bool withNormals, withColours;
+
+		std::vector<Vector3f> vertices;
+		/// Empty, or one unit normal per vertex
+		std::vector<Vector3f> normals;
+		/// Empty, or one colour per vertex
+		std::vector<Vector3u> colours;
+		/// Vertex indices of each triangle, in the same order as the corners p0, p1, p2 of ITMMesh::Triangle
+		std::vector<Vector3i> faces;
+
+		explicit ITMIndexedMesh(bool withNormals = true, bool withColours = true)
+		{
+			this->withNormals = withNormals;
+			this->withColours = withColours;
+		}
+
+		/// Whether the file name ends in .ply, i.e. asks for WritePLY rather than the triangle soup formats
+		static bool HasPLYExtension(const char *fileName)
+		{
+			size_t length = strlen(fileName);
+			return length >= 4 && (strcmp(fileName + length - 4, ".ply") == 0 || strcmp(fileName + length - 4, ".PLY") == 0);
+		}
+
+		void Clear()
+		{
+			vertices.clear(); normals.clear(); colours.clear(); faces.clear();
+		}
+
+		/** Builds the mesh from a triangle soup by merging corners
+		    with bit-identical positions, as produced by the meshing
+		    engines for edges shared between cells.
+		*/
+		void SetFromTriangles(const ITMMesh::Triangle *triangles, uint noTriangles)
+		{
+			Clear();
+
+			std::vector<WeldEntry> corners(noTriangles * 3);
+			for (uint i = 0; i < noTriangles; i++)
+			{
+				corners[i * 3 + 0].p = triangles[i].p0; corners[i * 3 + 0].cornerId = i * 3 + 0;
+				corners[i * 3 + 1].p = triangles[i].p1; corners[i * 3 + 1].cornerId = i * 3 + 1;
+				corners[i * 3 + 2].p = triangles[i].p2; corners[i * 3 + 2].cornerId = i * 3 + 2;
+			}
+
+			std::sort(corners.begin(), corners.end());
+
+			std::vector<int> cornerVertex(corners.size());
+			for (size_t i = 0; i < corners.size(); i++)
+			{
+				if (i == 0 || !(corners[i - 1].p == corners[i].p)) vertices.push_back(corners[i].p);
+				cornerVertex[corners[i].cornerId] = (int)vertices.size() - 1;
+			}
+
+			faces.resize(noTriangles);
+			for (uint i = 0; i < noTriangles; i++)
+				faces[i] = Vector3i(cornerVertex[i * 3 + 0], cornerVertex[i * 3 + 1], cornerVertex[i * 3 + 2]);
+		}
+
+		/// Sets the vertex normals to the area weighted average of the normals of the adjacent faces
+		void ComputeNormalsFromFaces()
+		{
+			normals.assign(vertices.size(), Vector3f(0.0f));
+
+			for (size_t i = 0; i < faces.size(); i++)
+			{
+				const Vector3f &p0 = vertices[faces[i].x], &p1 = vertices[faces[i].y], &p2 = vertices[faces[i].z];
+				// the surface faces the side of p0, p2, p1 winding counter-clockwise, as written out by WritePLY and WriteSTL
+				Vector3f faceNormal = cross(p2 - p0, p1 - p0);
+
+				normals[faces[i].x] += faceNormal; normals[faces[i].y] += faceNormal; normals[faces[i].z] += faceNormal;
+			}
+
+			for (size_t i = 0; i < normals.size(); i++)
+			{
+				float norm = sqrt(dot(normals[i], normals[i]));
+				if (norm > 0.0f) normals[i] /= norm;
+			}
+		}
+
+		/** Writes the mesh as binary PLY in the byte order of the host,
+		    with the same face orientation as ITMMesh::WriteSTL.
+		*/
+		void WritePLY(const char *fileName) const
+		{
+			FILE *f = fopen(fileName, "wb");
+			if (f == NULL) return;
+
+			bool hasNormals = !normals.empty() && normals.size() == vertices.size();
+			bool hasColours = !colours.empty() && colours.size() == vertices.size();
+
+			const int one = 1;
+			bool littleEndian = *(const char*)&one == 1;
+
+			fprintf(f, "ply\nformat %s 1.0\n", littleEndian ? "binary_little_endian" : "binary_big_endian");
+			fprintf(f, "element vertex %d\nproperty float x\nproperty float y\nproperty float z\n", (int)vertices.size());
+			if (hasNormals) fprintf(f, "property float nx\nproperty float ny\nproperty float nz\n");
+			if (hasColours) fprintf(f, "property uchar red\nproperty uchar green\nproperty uchar blue\n");
+			fprintf(f, "element face %d\nproperty list uchar int vertex_indices\nend_header\n", (int)faces.size());
+
+			const size_t flushSize = 1 << 20;
+			std::vector<char> buffer;
+			buffer.reserve(flushSize + 64);
+
+			for (size_t i = 0; i < vertices.size(); i++)
+			{
+				AppendToBuffer(buffer, &vertices[i], sizeof(Vector3f));
+				if (hasNormals) AppendToBuffer(buffer, &normals[i], sizeof(Vector3f));
+				if (hasColours) AppendToBuffer(buffer, &colours[i], sizeof(Vector3u));
+
+				if (buffer.size() >= flushSize) { fwrite(&buffer[0], 1, buffer.size(), f); buffer.clear(); }
+			}
+
+			const unsigned char noFaceVertices = 3;
+			for (size_t i = 0; i < faces.size(); i++)
+			{
+				Vector3i face(faces[i].z, faces[i].y, faces[i].x);
+				AppendToBuffer(buffer, &noFaceVertices, sizeof(unsigned char));
+				AppendToBuffer(buffer, &face, sizeof(Vector3i));
+
+				if (buffer.size() >= flushSize) { fwrite(&buffer[0], 1, buffer.size(), f); buffer.clear(); }
+			}
+
+			if (!buffer.empty()) fwrite(&buffer[0], 1, buffer.size(), f);
+			fclose(f);
+		}
+	};
+}
@@ -18,8 +18,14 @@ namespace ITMLib
 
 		uint noTotalTriangles;
 		static const uint noMaxTriangles_default = SDF_LOCAL_BLOCK_NUM * 32 * 16;
+		/// Storage grows in multiples of this many triangles
+		static const uint noTrianglesPerChunk = 1 << 16;
+		/// Upper limit on the triangle storage, the mesh never allocates more than this
 		uint noMaxTriangles;
+		/// Number of triangles the meshing engine produced beyond noMaxTriangles and had to drop
+		uint noDroppedTriangles;
 
+		/// Triangle storage, holds GetCapacity() triangles of which the first noTotalTriangles are valid
 		ORUtils::MemoryBlock<Triangle> *triangles;
 
 		explicit ITMMesh(MemoryDeviceType memoryType, uint maxTriangles = noMaxTriangles_default)
@@ -27,8 +33,32 @@ namespace ITMLib
 			this->memoryType = memoryType;
 			this->noTotalTriangles = 0;
 			this->noMaxTriangles = maxTriangles;
+			this->noDroppedTriangles = 0;
 
-			triangles = new ORUtils::MemoryBlock<Triangle>(noMaxTriangles, memoryType);
+			triangles = new ORUtils::MemoryBlock<Triangle>(0, memoryType);
+		}
+
+		uint GetCapacity() const { return (uint)triangles->dataSize; }
+
+		/** Makes room for at least noTriangles triangles, but no more than noMaxTriangles, and returns the new capacity.
+		    Growing the storage does not preserve its contents.
+		*/
+		uint ReserveTriangles(uint noTriangles)
+		{
+			if (noTriangles > noMaxTriangles) noTriangles = noMaxTriangles;
+			if (noTriangles <= GetCapacity()) return GetCapacity();
+
+			size_t newCapacity = ((size_t)noTriangles + noTrianglesPerChunk - 1) / noTrianglesPerChunk * noTrianglesPerChunk;
+			triangles->Resize(MIN(newCapacity, (size_t)noMaxTriangles));
+
+			return GetCapacity();
+		}
+
+		/// Records that the meshing engine produced noProducedTriangles triangles, of which only those that fit were stored
+		void SetNoProducedTriangles(uint noProducedTriangles)
+		{
+			noTotalTriangles = MIN(noProducedTriangles, GetCapacity());
+			noDroppedTriangles = noProducedTriangles - noTotalTriangles;
 		}
 
 		void WriteOBJ(const char *fileName)
@@ -36,7 +66,7 @@ namespace ITMLib
 			ORUtils::MemoryBlock<Triangle> *cpu_triangles; bool shoulDelete = false;
 			if (memoryType == MEMORYDEVICE_CUDA)
 			{
-				cpu_triangles = new ORUtils::MemoryBlock<Triangle>(noMaxTriangles, MEMORYDEVICE_CPU);
+				cpu_triangles = new ORUtils::MemoryBlock<Triangle>(GetCapacity(), MEMORYDEVICE_CPU);
 				cpu_triangles->SetFrom(triangles, ORUtils::MemoryBlock<Triangle>::CUDA_TO_CPU);
 				shoulDelete = true;
 			}
@@ -66,7 +96,7 @@ namespace ITMLib
 			ORUtils::MemoryBlock<Triangle> *cpu_triangles; bool shoulDelete = false;
 			if (memoryType == MEMORYDEVICE_CUDA)
 			{
-				cpu_triangles = new ORUtils::MemoryBlock<Triangle>(noMaxTriangles, MEMORYDEVICE_CPU);
+				cpu_triangles = new ORUtils::MemoryBlock<Triangle>(GetCapacity(), MEMORYDEVICE_CPU);
 				cpu_triangles->SetFrom(triangles, ORUtils::MemoryBlock<Triangle>::CUDA_TO_CPU);
 				shoulDelete = true;
 			}
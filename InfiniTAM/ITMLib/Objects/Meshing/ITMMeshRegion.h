@@ -0,0 +1,111 @@
+// Copyright 2014-2017 Oxford University Innovation Limited and the authors of InfiniTAM
+
+#pragma once
+
+#include "../Camera/ITMIntrinsics.h"
+#include "../../../ORUtils/SE3Pose.h"
+
+namespace ITMLib
+{
+	/** \brief
+	    Region of space to which mesh extraction is restricted:
+	    either an axis-aligned box or the viewing frustum of a
+	    camera. All coordinates are in metres, in the world frame
+	    of the scene.
+	*/
+	class ITMMeshRegion
+	{
+	public:
+		enum RegionType { REGION_BOX, REGION_FRUSTUM };
+		RegionType type;
+
+		/** Corners of the box, or the bounding box of the frustum. */
+		Vector3f boxMin, boxMax;
+
+		/** World to camera transformation, intrinsics (fx, fy, cx, cy),
+		    image size and depth range of the frustum.
+		*/
+		Matrix4f M;
+		Vector4f projParams;
+		Vector2i imgSize;
+		float zNear, zFar;
+
+		ITMMeshRegion(const Vector3f &boxMin, const Vector3f &boxMax)
+		{
+			this->type = REGION_BOX;
+			this->boxMin = boxMin;
+			this->boxMax = boxMax;
+		}
+
+		ITMMeshRegion(const ORUtils::SE3Pose &pose, const ITMIntrinsics &intrinsics, const Vector2i &imgSize, float zNear, float zFar)
+		{
+			this->type = REGION_FRUSTUM;
+			this->M = pose.GetM();
+			this->projParams = intrinsics.projectionParamsSimple.all;
+			this->imgSize = imgSize;
+			this->zNear = zNear;
+			this->zFar = zFar;
+
+			Matrix4f invM = pose.GetInvM();
+			boxMin = Vector3f(1e30f); boxMax = Vector3f(-1e30f);
+
+			for (int cornerId = 0; cornerId < 8; cornerId++)
+			{
+				float z = (cornerId & 4) ? zFar : zNear;
+				float u = (cornerId & 1) ? (float)imgSize.x : 0.0f, v = (cornerId & 2) ? (float)imgSize.y : 0.0f;
+
+				Vector4f corner_camera((u - projParams.z) / projParams.x * z, (v - projParams.w) / projParams.y * z, z, 1.0f);
+				Vector3f corner = (invM * corner_camera).toVector3();
+
+				boxMin.x = MIN(boxMin.x, corner.x); boxMin.y = MIN(boxMin.y, corner.y); boxMin.z = MIN(boxMin.z, corner.z);
+				boxMax.x = MAX(boxMax.x, corner.x); boxMax.y = MAX(boxMax.y, corner.y); boxMax.z = MAX(boxMax.z, corner.z);
+			}
+		}
+
+		/** Range of block coordinates covered by the bounding box,
+		    for blocks of the given size in metres.
+		*/
+		void GetBlockRange(float blockSize, Vector3i &blockMin, Vector3i &blockMax) const
+		{
+			// clamped to the coordinates the hash can address
+			for (int i = 0; i < 3; i++)
+			{
+				blockMin[i] = (int)MAX(floor(boxMin[i] / blockSize), -32768.0f);
+				blockMax[i] = (int)MIN(floor(boxMax[i] / blockSize), 32767.0f);
+			}
+		}
+
+		/** Whether the block with the given coordinates and size in
+		    metres may overlap the region. For frustums the test is
+		    conservative: only blocks entirely outside one of the
+		    bounding planes are rejected.
+		*/
+		_CPU_AND_GPU_CODE_ bool OverlapsBlock(const Vector3i &blockPos, float blockSize) const
+		{
+			Vector3f blockMin = blockPos.toFloat() * blockSize, blockMax = blockMin + Vector3f(blockSize);
+
+			if (blockMax.x < boxMin.x || blockMax.y < boxMin.y || blockMax.z < boxMin.z) return false;
+			if (blockMin.x > boxMax.x || blockMin.y > boxMax.y || blockMin.z > boxMax.z) return false;
+			if (type == REGION_BOX) return true;
+
+			// whether any corner lies inside the near, far, left, right, top and bottom planes
+			int insidePlanes[6] = { 0, 0, 0, 0, 0, 0 };
+
+			for (int cornerId = 0; cornerId < 8; cornerId++)
+			{
+				Vector4f corner((cornerId & 1) ? blockMax.x : blockMin.x, (cornerId & 2) ? blockMax.y : blockMin.y, (cornerId & 4) ? blockMax.z : blockMin.z, 1.0f);
+				Vector4f p = M * corner;
+
+				if (p.z >= zNear) insidePlanes[0] = 1;
+				if (p.z <= zFar) insidePlanes[1] = 1;
+				if (projParams.x * p.x + projParams.z * p.z >= 0.0f) insidePlanes[2] = 1;
+				if (((float)imgSize.x - projParams.z) * p.z - projParams.x * p.x >= 0.0f) insidePlanes[3] = 1;
+				if (projParams.y * p.y + projParams.w * p.z >= 0.0f) insidePlanes[4] = 1;
+				if (((float)imgSize.y - projParams.w) * p.z - projParams.y * p.y >= 0.0f) insidePlanes[5] = 1;
+			}
+
+			for (int planeId = 0; planeId < 6; planeId++) if (!insidePlanes[planeId]) return false;
+			return true;
+		}
+	};
+}
@@ -0,0 +1,189 @@
+// Copyright 2014-2017 Oxford University Innovation Limited and the authors of InfiniTAM
+
+#pragma once
+
+#include "ITMMesh.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+namespace ITMLib
+{
+	/** \brief
+	    Writes a triangle soup to a file while it is being meshed.
+	    Triangles are appended in batches and only a fixed size
+	    output buffer is held in memory, so that meshes larger than
+	    the host memory can be exported. The triangle count in the
+	    header is filled in by Close.
+
+	    The format follows the file name: binary PLY for .ply, OBJ
+	    for .obj and binary STL otherwise, with the same face
+	    orientation as ITMMesh::WriteSTL. As the triangles are not
+	    welded, PLY and OBJ files list three vertices per triangle.
+	*/
+	class ITMMeshWriter
+	{
+	public:
+		enum FileFormat { FORMAT_STL, FORMAT_PLY, FORMAT_OBJ };
+
+	private:
+		FILE *file;
+		FileFormat format;
+		uint noTriangles;
+
+		std::vector<char> buffer;
+		size_t flushSize;
+
+		void Append(const void *data, size_t size)
+		{
+			const char *bytes = (const char*)data;
+			buffer.insert(buffer.end(), bytes, bytes + size);
+		}
+
+		void Flush()
+		{
+			if (!buffer.empty()) fwrite(&buffer[0], 1, buffer.size(), file);
+			buffer.clear();
+		}
+
+		/// Writes the header, with the counts in fixed width so that it can be rewritten in place once they are known
+		void WriteHeader()
+		{
+			if (format == FORMAT_STL)
+			{
+				char header[80];
+				memset(header, ' ', sizeof(header));
+				fwrite(header, 1, sizeof(header), file);
+				fwrite(&noTriangles, sizeof(uint), 1, file);
+			}
+			else if (format == FORMAT_PLY)
+			{
+				const int one = 1;
+				bool littleEndian = *(const char*)&one == 1;
+
+				fprintf(file, "ply\nformat %s 1.0\n", littleEndian ? "binary_little_endian" : "binary_big_endian");
+				fprintf(file, "element vertex %010u\nproperty float x\nproperty float y\nproperty float z\n", noTriangles * 3);
+				fprintf(file, "element face %010u\nproperty list uchar int vertex_indices\nend_header\n", noTriangles);
+			}
+		}
+
+	public:
+		static FileFormat FormatFromFileName(const char *fileName)
+		{
+			size_t length = strlen(fileName);
+			const char *extension = length >= 4 ? fileName + length - 4 : fileName;
+
+			if (strcmp(extension, ".ply") == 0 || strcmp(extension, ".PLY") == 0) return FORMAT_PLY;
+			if (strcmp(extension, ".obj") == 0 || strcmp(extension, ".OBJ") == 0) return FORMAT_OBJ;
+			return FORMAT_STL;
+		}
+
+		explicit ITMMeshWriter(size_t flushSize = 1 << 20)
+		{
+			this->file = NULL;
+			this->format = FORMAT_STL;
+			this->noTriangles = 0;
+			this->flushSize = flushSize;
+		}
+
+		~ITMMeshWriter() { Close(); }
+
+		/// Opens the file and writes the header, returns false if the file could not be opened
+		bool Open(const char *fileName)
+		{
+			Close();
+
+			format = FormatFromFileName(fileName);
+			noTriangles = 0;
+
+			file = fopen(fileName, format == FORMAT_OBJ ? "w" : "wb");
+			if (file == NULL) return false;
+
+			buffer.reserve(flushSize + 256);
+			WriteHeader();
+			return true;
+		}
+
+		bool IsOpen() const { return file != NULL; }
+
+		/// Number of triangles written since the file was opened
+		uint GetNoTriangles() const { return noTriangles; }
+
+		/// Appends the triangles, which are expected in host memory
+		void WriteTriangles(const ITMMesh::Triangle *triangles, size_t count)
+		{
+			if (file == NULL) return;
+
+			const float zero[3] = { 0.0f, 0.0f, 0.0f };
+			const short attribute = 0;
+
+			for (size_t i = 0; i < count; i++)
+			{
+				const ITMMesh::Triangle &triangle = triangles[i];
+
+				switch (format)
+				{
+				case FORMAT_STL:
+					Append(zero, sizeof(zero));
+					Append(&triangle.p2, sizeof(Vector3f)); Append(&triangle.p1, sizeof(Vector3f)); Append(&triangle.p0, sizeof(Vector3f));
+					Append(&attribute, sizeof(short));
+					break;
+				case FORMAT_PLY:
+					// the faces are implied by the order of the vertices and written by Close
+					Append(&triangle.p0, sizeof(Vector3f)); Append(&triangle.p1, sizeof(Vector3f)); Append(&triangle.p2, sizeof(Vector3f));
+					break;
+				case FORMAT_OBJ:
+				{
+					// faces may refer to any vertex listed before them, so each triangle follows its own vertices
+					char line[256];
+					uint firstVertex = noTriangles * 3 + 1;
+					int length = sprintf(line, "v %f %f %f\nv %f %f %f\nv %f %f %f\nf %u %u %u\n",
+						triangle.p0.x, triangle.p0.y, triangle.p0.z, triangle.p1.x, triangle.p1.y, triangle.p1.z,
+						triangle.p2.x, triangle.p2.y, triangle.p2.z, firstVertex + 2, firstVertex + 1, firstVertex);
+					Append(line, length);
+					break;
+				}
+				}
+
+				noTriangles++;
+				if (buffer.size() >= flushSize) Flush();
+			}
+		}
+
+		/// Writes the faces that are still missing, fills in the counts and closes the file
+		void Close()
+		{
+			if (file == NULL) return;
+
+			if (format == FORMAT_PLY)
+			{
+				const unsigned char noFaceVertices = 3;
+				for (uint i = 0; i < noTriangles; i++)
+				{
+					Vector3i face(i * 3 + 2, i * 3 + 1, i * 3);
+					Append(&noFaceVertices, sizeof(unsigned char));
+					Append(&face, sizeof(Vector3i));
+
+					if (buffer.size() >= flushSize) Flush();
+				}
+			}
+
+			Flush();
+
+			if (format != FORMAT_OBJ)
+			{
+				fseek(file, 0, SEEK_SET);
+				WriteHeader();
+			}
+
+			fclose(file);
+			file = NULL;
+			std::vector<char>().swap(buffer);
+		}
+
+		// Suppress the default copy constructor and assignment operator
+		ITMMeshWriter(const ITMMeshWriter&);
+		ITMMeshWriter& operator=(const ITMMeshWriter&);
+	};
+}
@@ -5,6 +5,7 @@
 #ifndef __METALC__
 
 #include "../../Utils/ITMMath.h"
+#include "../../Utils/ITMProjectionUtils.h"
 #include "../../../ORUtils/Image.h"
 
 namespace ITMLib
@@ -15,6 +16,23 @@ namespace ITMLib
 		*/
 	class ITMRenderState
 	{
+	private:
+		/** Number of ray direction tables kept at once, enough for
+		the depth camera used by the allocation and the possibly
+		different camera used by the raycasts of the same frame.
+		*/
+		static const int noRayDirectionTables = 2;
+
+		/** Per-pixel unit viewing rays, see GetRayDirections(). The
+		tables are a cache, so they may be refreshed by otherwise
+		const raycasting operations.
+		*/
+		mutable ORUtils::Image<Vector4f> *rayDirections[noRayDirectionTables];
+		mutable Vector4f rayDirections_projParams[noRayDirectionTables];
+		/// Index of the table that was used last, the other one is replaced on a miss
+		mutable int rayDirections_lastUsed;
+		MemoryDeviceType rayDirections_memoryType;
+
 	public:
 		/** @brief
 		Gives the raycasting operations an idea of the
@@ -52,6 +70,14 @@ namespace ITMLib
 			fwdProjMissingPoints = new ORUtils::Image<int>(imgSize, memoryType);
 			raycastImage = new ORUtils::Image<Vector4u>(imgSize, memoryType);
 
+			for (int i = 0; i < noRayDirectionTables; i++)
+			{
+				rayDirections[i] = new ORUtils::Image<Vector4f>(imgSize, true, memoryType == MEMORYDEVICE_CUDA);
+				rayDirections_projParams[i] = Vector4f(0.0f);
+			}
+			rayDirections_lastUsed = 0;
+			rayDirections_memoryType = memoryType;
+
 			ORUtils::Image<Vector2f> *buffImage = new ORUtils::Image<Vector2f>(imgSize, MEMORYDEVICE_CPU);
 
 			Vector2f v_lims(vf_min, vf_max);
@@ -70,8 +96,43 @@ namespace ITMLib
 			noFwdProjMissingPoints = 0;
 		}
 
+		/** Get the table of unit viewing rays in camera coordinates
+		for each pixel of an image of size imgSize with projection
+		parameters projParams, with the distance along the ray per
+		unit of depth in w (see computeRayDirection). The tables for
+		the last two distinct cameras are kept, so a table is only
+		recomputed if neither of them matches.
+		*/
+		const Vector4f *GetRayDirections(const Vector4f &projParams, const Vector2i &imgSize) const
+		{
+			int tableId = -1;
+			for (int i = 0; i < noRayDirectionTables; i++)
+			{
+				if (projParams == rayDirections_projParams[i] && imgSize == rayDirections[i]->noDims) { tableId = i; break; }
+			}
+
+			if (tableId < 0)
+			{
+				tableId = (rayDirections_lastUsed + 1) % noRayDirectionTables;
+				ORUtils::Image<Vector4f> *table = rayDirections[tableId];
+				table->ChangeDims(imgSize, false);
+
+				Vector4f invProjParams(1.0f / projParams.x, 1.0f / projParams.y, -projParams.z, -projParams.w);
+				Vector4f *rayDirections_host = table->GetData(MEMORYDEVICE_CPU);
+				for (int y = 0; y < imgSize.y; ++y) for (int x = 0; x < imgSize.x; ++x)
+					rayDirections_host[x + y * imgSize.x] = computeRayDirection(x, y, invProjParams);
+
+				if (rayDirections_memoryType == MEMORYDEVICE_CUDA) table->UpdateDeviceFromHost();
+				rayDirections_projParams[tableId] = projParams;
+			}
+
+			rayDirections_lastUsed = tableId;
+			return rayDirections[tableId]->GetData(rayDirections_memoryType);
+		}
+
 		virtual ~ITMRenderState()
 		{
+			for (int i = 0; i < noRayDirectionTables; i++) delete rayDirections[i];
 			delete renderingRangeImage;
 			delete raycastResult;
 			delete forwardProjection;
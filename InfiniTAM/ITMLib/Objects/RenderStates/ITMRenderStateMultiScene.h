@@ -28,6 +28,12 @@ namespace ITMLib {
 
 		ITMSceneParams sceneParams;
 
+		/** Bounding box of the allocated blocks of each local map, in
+		block coordinates of that map, as kept by its index. Used for
+		culling local maps outside the view frustum.
+		*/
+		Vector3s localMapBounds_min[MAX_NUM_LOCALMAPS], localMapBounds_max[MAX_NUM_LOCALMAPS];
+
 		ITMRenderStateMultiScene(const Vector2i &imgSize, float vf_min, float vf_max, MemoryDeviceType _memoryType)
 			: ITMRenderState(imgSize, vf_min, vf_max, _memoryType)
 		{
@@ -60,6 +60,22 @@ namespace ITMLib
 		*/
 		uchar *GetEntriesVisibleType(void) { return entriesVisibleType->GetData(memoryType); }
 
+		/** Copy the list of "visible entries" to host memory.
+		@p dest has to provide space for noVisibleEntries elements.
+		*/
+		void CopyVisibleEntryIDsToHost(int *dest) const
+		{
+			if (noVisibleEntries <= 0) return;
+
+			if (memoryType == MEMORYDEVICE_CUDA)
+			{
+#ifndef COMPILE_WITHOUT_CUDA
+				ORcudaSafeCall(cudaMemcpy(dest, visibleEntryIDs->GetData(MEMORYDEVICE_CUDA), noVisibleEntries * sizeof(int), cudaMemcpyDeviceToHost));
+#endif
+			}
+			else memcpy(dest, visibleEntryIDs->GetData(MEMORYDEVICE_CPU), noVisibleEntries * sizeof(int));
+		}
+
 #ifdef COMPILE_WITH_METAL
 		const void* GetVisibleEntryIDs_MB(void) { return visibleEntryIDs->GetMetalBuffer(); }
 		const void* GetEntriesVisibleType_MB(void) { return entriesVisibleType->GetMetalBuffer(); }
@@ -40,8 +40,13 @@ namespace ITMLib
 			index.LoadFromDirectory(outputDirectory);			
 		}
 
-		ITMScene(const ITMSceneParams *_sceneParams, bool _useSwapping, MemoryDeviceType _memoryType)
-			: sceneParams(_sceneParams), index(_memoryType), localVBA(_memoryType, index.getNumAllocatedVoxelBlocks(), index.getVoxelBlockSize())
+		/** With noVoxelBlocks the local VBA holds that many blocks
+		    instead of the number the index can allocate, e.g. for
+		    snapshots that hold the allocated blocks of another scene.
+		*/
+		ITMScene(const ITMSceneParams *_sceneParams, bool _useSwapping, MemoryDeviceType _memoryType, int noVoxelBlocks = -1)
+			: sceneParams(_sceneParams), index(_memoryType),
+			  localVBA(_memoryType, noVoxelBlocks >= 0 ? noVoxelBlocks : index.getNumAllocatedVoxelBlocks(), index.getVoxelBlockSize())
 		{
 			if (_useSwapping) globalCache = new ITMGlobalCache<TVoxel>();
 			else globalCache = NULL;
@@ -3,6 +3,7 @@
 #pragma once
 
 #ifndef __METALC__
+#include <climits>
 #include <stdlib.h>
 #include <fstream>
 #include <iostream>
@@ -83,6 +84,35 @@ namespace ITMLib
 		*/
 		ORUtils::MemoryBlock<int> *excessAllocationList;
 
+		/** Modification stamp of each entry, i.e. the modification
+		count at which the voxels of the entry were last changed,
+		or the entry was swapped out or cleaned.
+		*/
+		ORUtils::MemoryBlock<uint> *modificationStamps;
+
+		/** Incremented by every operation that changes voxels. */
+		uint modificationCount;
+
+		/** Modification count at which all entries were last
+		invalidated at once, e.g. by a reset or a load.
+		*/
+		uint allModifiedStamp;
+
+		/** Number of times the stamps were cleared and the
+		modification count restarted, so that consumers can tell a
+		restarted count from an unchanged one.
+		*/
+		uint noModificationResets;
+
+		/** Bounding box of the positions of all entries allocated
+		since the table was last reset, in block coordinates. It is
+		grown by the allocation and never shrunk, so it also covers
+		entries that were swapped out or cleaned since. Only valid
+		while allocationBoundsKnown is set.
+		*/
+		Vector3s allocationBounds_min, allocationBounds_max;
+		bool allocationBoundsKnown;
+
 		MemoryDeviceType memoryType;
 
 	public:
@@ -91,12 +121,19 @@ namespace ITMLib
 			this->memoryType = memoryType;
 			hashEntries = new ORUtils::MemoryBlock<ITMHashEntry>(noTotalEntries, memoryType);
 			excessAllocationList = new ORUtils::MemoryBlock<int>(SDF_EXCESS_LIST_SIZE, memoryType);
+			modificationStamps = new ORUtils::MemoryBlock<uint>(noTotalEntries, memoryType);
+			modificationStamps->Clear();
+			modificationCount = 0;
+			allModifiedStamp = 0;
+			noModificationResets = 0;
+			allocationBoundsKnown = false;
 		}
 
 		~ITMVoxelBlockHash(void)
 		{
 			delete hashEntries;
 			delete excessAllocationList;
+			delete modificationStamps;
 		}
 
 		/** Get the list of actual entries in the hash table. */
@@ -116,6 +153,70 @@ namespace ITMLib
 		int GetLastFreeExcessListId(void) { return lastFreeExcessListId; }
 		void SetLastFreeExcessListId(int lastFreeExcessListId) { this->lastFreeExcessListId = lastFreeExcessListId; }
 
+		/** Get the modification stamp of each entry. Engines that
+		change voxels write the value returned by
+		AdvanceModificationCount to the entries they touch, so that
+		consumers such as the meshing engines can find the entries
+		changed since they last looked at the scene.
+		*/
+		const uint *GetModificationStamps(void) const { return modificationStamps->GetData(memoryType); }
+		uint *GetModificationStamps(void) { return modificationStamps->GetData(memoryType); }
+
+		uint GetModificationCount(void) const { return modificationCount; }
+		uint AdvanceModificationCount(void) { return ++modificationCount; }
+
+		/** Marks all entries as modified, for changes that replace the whole table. */
+		void MarkAllModified(void) { allModifiedStamp = ++modificationCount; }
+		uint GetAllModifiedStamp(void) const { return allModifiedStamp; }
+
+		/** Clears the stamps, restarts the modification count and
+		marks all entries as modified, for resets and loads that
+		discard the previous contents of the table.
+		*/
+		void ResetModificationStamps(void)
+		{
+			modificationStamps->Clear();
+			modificationCount = 0;
+			allModifiedStamp = 0;
+			noModificationResets++;
+			MarkAllModified();
+		}
+		uint GetNoModificationResets(void) const { return noModificationResets; }
+
+		/** Get the bounding box of the allocated entries, see
+		GrowAllocationBounds. Returns false if it is not known, e.g.
+		after the table was loaded or allocated on the GPU, in which
+		case it has to be found from the entries and set again with
+		SetAllocationBounds. The box is empty (min > max) if nothing
+		has been allocated.
+		*/
+		bool GetAllocationBounds(Vector3s &boundsMin, Vector3s &boundsMax) const
+		{
+			if (!allocationBoundsKnown) return false;
+			boundsMin = allocationBounds_min; boundsMax = allocationBounds_max;
+			return true;
+		}
+
+		void SetAllocationBounds(const Vector3s &boundsMin, const Vector3s &boundsMax)
+		{
+			allocationBounds_min = boundsMin; allocationBounds_max = boundsMax;
+			allocationBoundsKnown = true;
+		}
+
+		/** Called by the allocation for each newly allocated entry. */
+		void GrowAllocationBounds(const Vector3s &pos)
+		{
+			allocationBounds_min.x = MIN(allocationBounds_min.x, pos.x); allocationBounds_max.x = MAX(allocationBounds_max.x, pos.x);
+			allocationBounds_min.y = MIN(allocationBounds_min.y, pos.y); allocationBounds_max.y = MAX(allocationBounds_max.y, pos.y);
+			allocationBounds_min.z = MIN(allocationBounds_min.z, pos.z); allocationBounds_max.z = MAX(allocationBounds_max.z, pos.z);
+		}
+
+		/** Empties the allocation bounds, for a reset of the table. */
+		void ResetAllocationBounds(void) { SetAllocationBounds(Vector3s((short)SHRT_MAX), Vector3s((short)SHRT_MIN)); }
+
+		/** Forgets the allocation bounds, for changes that allocate entries without reporting their positions. */
+		void InvalidateAllocationBounds(void) { allocationBoundsKnown = false; }
+
 #ifdef COMPILE_WITH_METAL
 		const void* GetEntries_MB(void) { return hashEntries->GetMetalBuffer(); }
 		const void* GetExcessAllocationList_MB(void) { return excessAllocationList->GetMetalBuffer(); }
@@ -152,6 +253,9 @@ namespace ITMLib
 			ifs >> this->lastFreeExcessListId;
 			ORUtils::MemoryBlockPersister::LoadMemoryBlock(hashEntriesFileName.c_str(), *hashEntries, memoryType);
 			ORUtils::MemoryBlockPersister::LoadMemoryBlock(excessAllocationListFileName.c_str(), *excessAllocationList, memoryType);
+
+			ResetModificationStamps();
+			InvalidateAllocationBounds();
 		}
 
 		// Suppress the default copy constructor and assignment operator
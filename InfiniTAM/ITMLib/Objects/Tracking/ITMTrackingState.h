@@ -35,6 +35,17 @@ namespace ITMLib
 		/// Current pose of the depth camera.
 		ORUtils::SE3Pose *pose_d;
 
+		/// Size of the correction the tracker applied to the predicted
+		/// pose of the last frame, or -1 if it is not known.
+		float lastPoseUpdate;
+
+		/// Pose of the depth camera before the current frame was
+		/// tracked, and the pose the motion model predicted for it.
+		/// The motion model is only applied if hasPreviousPose is set.
+		ORUtils::SE3Pose *pose_previous;
+		ORUtils::SE3Pose *pose_predicted;
+		bool hasPreviousPose;
+
 		/// Tracking quality: 1.0: success, 0.0: failure
 		enum TrackingResult
 		{
@@ -43,6 +54,15 @@ namespace ITMLib
 			TRACKING_FAILED = 0
 		} trackerResult;
 
+		/// Tracking quality of the previous frame, kept while the
+		/// trackers overwrite trackerResult for the current one.
+		TrackingResult lastTrackerResult;
+
+		/// Score the tracker's quality classifier gave the last frame,
+		/// which orders poses tracked with the same result. Trackers
+		/// without a classifier leave it unchanged.
+		float trackerScore;
+
 		bool TrackerFarFromPointCloud(void) const
 		{
 			// if no point cloud exists, yet
@@ -50,8 +70,14 @@ namespace ITMLib
 			// if the point cloud is older than n frames
 			if (age_pointCloud > 5) return true;
 
+			return PoseFarFromPointCloud(pose_d);
+		}
+
+		/// Whether a camera at the given pose has moved too far from the pose of the point cloud to keep using it
+		bool PoseFarFromPointCloud(const ORUtils::SE3Pose *pose) const
+		{
 			Vector3f cameraCenter_pc = -1.0f * (pose_pointCloud->GetR().t() * pose_pointCloud->GetT());
-			Vector3f cameraCenter_live = -1.0f * (pose_d->GetR().t() * pose_d->GetT());
+			Vector3f cameraCenter_live = -1.0f * (pose->GetR().t() * pose->GetT());
 
 			Vector3f diff3 = cameraCenter_pc - cameraCenter_live;
 
@@ -66,7 +92,9 @@ namespace ITMLib
 		ITMTrackingState(Vector2i imgSize, MemoryDeviceType memoryType)
 		: pointCloud(new ITMPointCloud(imgSize, memoryType)),
 			pose_pointCloud(new ORUtils::SE3Pose),
-			pose_d(new ORUtils::SE3Pose)
+			pose_d(new ORUtils::SE3Pose),
+			pose_previous(new ORUtils::SE3Pose),
+			pose_predicted(new ORUtils::SE3Pose)
 		{
 			Reset();
 		}
@@ -76,6 +104,8 @@ namespace ITMLib
 			delete pointCloud;
 			delete pose_d;
 			delete pose_pointCloud;
+			delete pose_previous;
+			delete pose_predicted;
 		}
 
 		void Reset()
@@ -84,6 +114,12 @@ namespace ITMLib
 			this->pose_d->SetFrom(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
 			this->pose_pointCloud->SetFrom(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
 			this->trackerResult = TRACKING_GOOD;
+			this->lastTrackerResult = TRACKING_GOOD;
+			this->trackerScore = 0.0f;
+			this->lastPoseUpdate = -1.0f;
+			this->pose_previous->SetFrom(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+			this->pose_predicted->SetFrom(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+			this->hasPreviousPose = false;
 		}
 
 		// Suppress the default copy constructor and assignment operator
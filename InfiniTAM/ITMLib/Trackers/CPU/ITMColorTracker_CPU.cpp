@@ -5,6 +5,9 @@
 
 using namespace ITMLib;
 
+/// Number of points summed into one cell, the cells are added up in a fixed order so that the sums do not depend on the number of threads
+static const int noPointsPerCell = 1024;
+
 ITMColorTracker_CPU::ITMColorTracker_CPU(Vector2i imgSize, TrackerIterationType *trackingRegime, int noHierarchyLevels, const ITMLowLevelEngine *lowLevelEngine)
 	: ITMColorTracker(imgSize, trackingRegime, noHierarchyLevels, lowLevelEngine, MEMORYDEVICE_CPU) {  }
 
@@ -28,13 +31,27 @@ int ITMColorTracker_CPU::F_oneLevel(float *f, ORUtils::SE3Pose *pose)
 	Vector4f *colours = trackingState->pointCloud->colours->GetData(MEMORYDEVICE_CPU);
 	Vector4u *rgb = viewHierarchy->GetLevel(levelId)->rgb->GetData(MEMORYDEVICE_CPU);
 
-	final_f = 0; countedPoints_valid = 0;
-	for (int locId = 0; locId < noTotalPoints; locId++)
+	int noCells = (noTotalPoints + noPointsPerCell - 1) / noPointsPerCell;
+	pointCells.assign(MAX(noCells, 1), ITMTrackerAccuCell());
+
+#ifdef WITH_OPENMP
+	#pragma omp parallel for
+#endif
+	for (int cellId = 0; cellId < noCells; cellId++)
 	{
-		float colorDiffSq = getColorDifferenceSq(locations, colours, rgb, imgSize, locId, projParams, M);
-		if (colorDiffSq >= 0) { final_f += colorDiffSq; countedPoints_valid++; }
+		ITMTrackerAccuCell &cell = pointCells[cellId];
+		int locEnd = MIN((cellId + 1) * noPointsPerCell, noTotalPoints);
+
+		for (int locId = cellId * noPointsPerCell; locId < locEnd; locId++)
+		{
+			float colorDiffSq = getColorDifferenceSq(locations, colours, rgb, imgSize, locId, projParams, M);
+			if (colorDiffSq >= 0) cell.Add(colorDiffSq, NULL, NULL, 0, 0);
+		}
 	}
 
+	ITMTrackerAccuCell::Reduce(pointCells);
+	final_f = pointCells[0].f; countedPoints_valid = pointCells[0].numPoints;
+
 	if (countedPoints_valid == 0) { final_f = 1e10; scaleForOcclusions = 1.0; }
 	else { scaleForOcclusions = (float)noTotalPoints / countedPoints_valid; }
 
@@ -60,33 +77,37 @@ void ITMColorTracker_CPU::G_oneLevel(float *gradient, float *hessian, ORUtils::S
 	bool rotationOnly = iterationType == TRACKER_ITERATION_ROTATION;
 	int numPara = rotationOnly ? 3 : 6, startPara = rotationOnly ? 3 : 0, numParaSQ = rotationOnly ? 3 + 2 + 1 : 6 + 5 + 4 + 3 + 2 + 1;
 
-	float globalGradient[6], globalHessian[21];
-	for (int i = 0; i < numPara; i++) globalGradient[i] = 0.0f;
-	for (int i = 0; i < numParaSQ; i++) globalHessian[i] = 0.0f;
-
 	Vector4f *locations = trackingState->pointCloud->locations->GetData(MEMORYDEVICE_CPU);
 	Vector4f *colours = trackingState->pointCloud->colours->GetData(MEMORYDEVICE_CPU);
 	Vector4u *rgb = viewHierarchy->GetLevel(levelId)->rgb->GetData(MEMORYDEVICE_CPU);
 	Vector4s *gx = viewHierarchy->GetLevel(levelId)->gradientX_rgb->GetData(MEMORYDEVICE_CPU);
 	Vector4s *gy = viewHierarchy->GetLevel(levelId)->gradientY_rgb->GetData(MEMORYDEVICE_CPU);
 
-	for (int locId = 0; locId < noTotalPoints; locId++)
+	int noCells = (noTotalPoints + noPointsPerCell - 1) / noPointsPerCell;
+	pointCells.assign(MAX(noCells, 1), ITMTrackerAccuCell());
+
+#ifdef WITH_OPENMP
+	#pragma omp parallel for
+#endif
+	for (int cellId = 0; cellId < noCells; cellId++)
 	{
-		float localGradient[6], localHessian[21];
+		ITMTrackerAccuCell &cell = pointCells[cellId];
+		int locEnd = MIN((cellId + 1) * noPointsPerCell, noTotalPoints);
 
-		computePerPointGH_rt_Color(localGradient, localHessian, locations, colours, rgb, imgSize, locId,
-			projParams, M, gx, gy, 6, 0);
+		for (int locId = cellId * noPointsPerCell; locId < locEnd; locId++)
+		{
+			float localGradient[6], localHessian[21];
 
-		bool isValidPoint = computePerPointGH_rt_Color(localGradient, localHessian, locations, colours, rgb, imgSize, locId,
-			projParams, M, gx, gy, numPara, startPara);
+			bool isValidPoint = computePerPointGH_rt_Color(localGradient, localHessian, locations, colours, rgb, imgSize, locId,
+				projParams, M, gx, gy, numPara, startPara);
 
-		if (isValidPoint)
-		{
-			for (int i = 0; i < numPara; i++) globalGradient[i] += localGradient[i];
-			for (int i = 0; i < numParaSQ; i++) globalHessian[i] += localHessian[i];
+			if (isValidPoint) cell.Add(0.0f, localGradient, localHessian, numPara, numParaSQ);
 		}
 	}
 
+	ITMTrackerAccuCell::Reduce(pointCells);
+	const float *globalGradient = pointCells[0].g, *globalHessian = pointCells[0].h;
+
 	scaleForOcclusions = (float)noTotalPoints / countedPoints_valid;
 	if (countedPoints_valid == 0) { scaleForOcclusions = 1.0f; }
 
@@ -3,11 +3,16 @@
 #pragma once
 
 #include "../Interface/ITMColorTracker.h"
+#include "ITMTrackerReduction_CPU.h"
 
 namespace ITMLib
 {
 	class ITMColorTracker_CPU : public ITMColorTracker
 	{
+	private:
+		/// Sums of each group of points, reused across evaluations. G_oneLevel is const, hence mutable.
+		mutable std::vector<ITMTrackerAccuCell> pointCells;
+
 	public:
 		int F_oneLevel(float *f, ORUtils::SE3Pose *pose);
 		void G_oneLevel(float *gradient, float *hessian, ORUtils::SE3Pose *pose) const;
@@ -8,10 +8,175 @@ using namespace ITMLib;
 ITMDepthTracker_CPU::ITMDepthTracker_CPU(Vector2i imgSize, TrackerIterationType *trackingRegime, int noHierarchyLevels,
 	float terminationThreshold, float failureDetectorThreshold, const ITMLowLevelEngine *lowLevelEngine)
  : ITMDepthTracker(imgSize, trackingRegime, noHierarchyLevels, terminationThreshold,  failureDetectorThreshold, lowLevelEngine, MEMORYDEVICE_CPU)
-{ }
+{
+	hasCachedCorrespondences = false;
+}
 
 ITMDepthTracker_CPU::~ITMDepthTracker_CPU(void) { }
 
+/// Number of pixels of a row whose view points are transformed together
+static const int noPointsPerChunk = 64;
+
+/// Number of selected points summed into each cell
+static const int noSelectedPointsPerCell = 256;
+
+/** Evaluates the points of one image row. The view points of each
+    chunk are first back-projected, transformed and projected into
+    the scene image in separate float arrays, which is a straight
+    loop over contiguous memory that the compiler can vectorise. The
+    scene points and normals are then gathered only for the points
+    that project into the scene image.
+
+    If cachedPoints and cachedNormals are given, the gathered scene
+    points and normals are stored there, or with reuseCorrespondences
+    the ones stored before are used without projecting the points.
+*/
+template<bool shortIteration, bool rotationOnly>
+static void computeRowGH_Depth(ITMTrackerAccuCell &rowCell, int y, const float *depthRow, const Vector2i &viewImageSize, const Vector4f &viewIntrinsics,
+	const Vector2i &sceneImageSize, const Vector4f &sceneIntrinsics, const Matrix4f &approxInvPose, const Matrix4f &scenePose,
+	const Vector4f *pointsMap, const Vector4f *normalsMap, float distThresh, Vector4f *cachedPoints, Vector4f *cachedNormals, bool reuseCorrespondences)
+{
+	const int noPara = shortIteration ? 3 : 6;
+
+	float pointX[noPointsPerChunk], pointY[noPointsPerChunk], pointZ[noPointsPerChunk];
+	float projX[noPointsPerChunk], projY[noPointsPerChunk];
+	bool isProjected[noPointsPerChunk];
+
+	const float *T = approxInvPose.m, *S = scenePose.m;
+	const float rowFactor = (float(y) - viewIntrinsics.w) / viewIntrinsics.y;
+	const float maxProjX = (float)(sceneImageSize.x - 2), maxProjY = (float)(sceneImageSize.y - 2);
+
+	for (int chunkStart = 0; chunkStart < viewImageSize.x; chunkStart += noPointsPerChunk)
+	{
+		int noPoints = MIN(noPointsPerChunk, viewImageSize.x - chunkStart);
+
+		if (reuseCorrespondences)
+		{
+			for (int i = 0; i < noPoints; i++)
+			{
+				float depth = depthRow[chunkStart + i];
+				float camX = depth * ((float(chunkStart + i) - viewIntrinsics.z) / viewIntrinsics.x), camY = depth * rowFactor;
+
+				// transform to previous frame coordinates
+				pointX[i] = T[0] * camX + T[4] * camY + T[8] * depth + T[12];
+				pointY[i] = T[1] * camX + T[5] * camY + T[9] * depth + T[13];
+				pointZ[i] = T[2] * camX + T[6] * camY + T[10] * depth + T[14];
+			}
+
+			for (int i = 0; i < noPoints; i++)
+			{
+				float A[noPara], b;
+				Vector4f tmp3Dpoint(pointX[i], pointY[i], pointZ[i], 1.0f);
+
+				if (computePerPointGH_Depth_Ab_Matched<shortIteration, rotationOnly>(A, b, tmp3Dpoint, cachedPoints[chunkStart + i], cachedNormals[chunkStart + i], distThresh))
+					rowCell.AddPoint(A, b, noPara);
+			}
+
+			continue;
+		}
+
+		for (int i = 0; i < noPoints; i++)
+		{
+			float depth = depthRow[chunkStart + i];
+			float camX = depth * ((float(chunkStart + i) - viewIntrinsics.z) / viewIntrinsics.x), camY = depth * rowFactor;
+
+			// transform to previous frame coordinates
+			float x = T[0] * camX + T[4] * camY + T[8] * depth + T[12];
+			float y = T[1] * camX + T[5] * camY + T[9] * depth + T[13];
+			float z = T[2] * camX + T[6] * camY + T[10] * depth + T[14];
+
+			// project into previous rendered image
+			float reprojX = S[0] * x + S[4] * y + S[8] * z + S[12];
+			float reprojY = S[1] * x + S[5] * y + S[9] * z + S[13];
+			float reprojZ = S[2] * x + S[6] * y + S[10] * z + S[14];
+
+			float u = sceneIntrinsics.x * reprojX / reprojZ + sceneIntrinsics.z;
+			float v = sceneIntrinsics.y * reprojY / reprojZ + sceneIntrinsics.w;
+
+			pointX[i] = x; pointY[i] = y; pointZ[i] = z; projX[i] = u; projY[i] = v;
+			isProjected[i] = (depth > 1e-8f) & (reprojZ > 0.0f) & (u >= 0.0f) & (u <= maxProjX) & (v >= 0.0f) & (v <= maxProjY);
+		}
+
+		for (int i = 0; i < noPoints; i++)
+		{
+			if (!isProjected[i])
+			{
+				if (cachedPoints != NULL) cachedPoints[chunkStart + i].w = -1.0f;
+				continue;
+			}
+
+			float A[noPara], b;
+			Vector4f tmp3Dpoint(pointX[i], pointY[i], pointZ[i], 1.0f);
+			Vector2f tmp2Dpoint(projX[i], projY[i]);
+
+			bool isValidPoint;
+			if (cachedPoints != NULL)
+			{
+				Vector4f &scenePoint = cachedPoints[chunkStart + i], &sceneNormal = cachedNormals[chunkStart + i];
+				scenePoint = interpolateBilinear_withHoles(pointsMap, tmp2Dpoint, sceneImageSize);
+				sceneNormal = interpolateBilinear_withHoles(normalsMap, tmp2Dpoint, sceneImageSize);
+
+				isValidPoint = computePerPointGH_Depth_Ab_Matched<shortIteration, rotationOnly>(A, b, tmp3Dpoint, scenePoint, sceneNormal, distThresh);
+			}
+			else isValidPoint = computePerPointGH_Depth_Ab_Correspondence<shortIteration, rotationOnly>(A, b, tmp3Dpoint, tmp2Dpoint, sceneImageSize, pointsMap, normalsMap, distThresh);
+
+			if (isValidPoint) rowCell.AddPoint(A, b, noPara);
+		}
+	}
+}
+
+/// Evaluates a group of selected points, given by their pixel indices, with the correspondence cache indexed like the view image
+template<bool shortIteration, bool rotationOnly>
+static void computeSelectedGH_Depth(ITMTrackerAccuCell &cell, const int *pointIds, int noPoints, const float *depth, const Vector2i &viewImageSize,
+	const Vector4f &viewIntrinsics, const Vector2i &sceneImageSize, const Vector4f &sceneIntrinsics, const Matrix4f &approxInvPose,
+	const Matrix4f &scenePose, const Vector4f *pointsMap, const Vector4f *normalsMap, float distThresh, Vector4f *cachedPoints, Vector4f *cachedNormals,
+	bool reuseCorrespondences)
+{
+	const int noPara = shortIteration ? 3 : 6;
+
+	for (int i = 0; i < noPoints; i++)
+	{
+		int locId = pointIds[i], x = locId % viewImageSize.x, y = locId / viewImageSize.x;
+		float A[noPara], b;
+		bool isValidPoint;
+
+		if (reuseCorrespondences)
+		{
+			float d = depth[locId];
+			Vector4f tmp3Dpoint(d * ((float(x) - viewIntrinsics.z) / viewIntrinsics.x), d * ((float(y) - viewIntrinsics.w) / viewIntrinsics.y), d, 1.0f);
+			tmp3Dpoint = approxInvPose * tmp3Dpoint;
+			tmp3Dpoint.w = 1.0f;
+
+			isValidPoint = computePerPointGH_Depth_Ab_Matched<shortIteration, rotationOnly>(A, b, tmp3Dpoint, cachedPoints[locId], cachedNormals[locId], distThresh);
+		}
+		else if (cachedPoints != NULL)
+		{
+			Vector4f tmp3Dpoint; Vector2f tmp2Dpoint;
+
+			if (computePerPointProjection_Depth(tmp3Dpoint, tmp2Dpoint, x, y, depth[locId], viewIntrinsics, sceneImageSize, sceneIntrinsics, approxInvPose, scenePose))
+			{
+				cachedPoints[locId] = interpolateBilinear_withHoles(pointsMap, tmp2Dpoint, sceneImageSize);
+				cachedNormals[locId] = interpolateBilinear_withHoles(normalsMap, tmp2Dpoint, sceneImageSize);
+			}
+			else cachedPoints[locId].w = -1.0f;
+
+			isValidPoint = computePerPointGH_Depth_Ab_Matched<shortIteration, rotationOnly>(A, b, tmp3Dpoint, cachedPoints[locId], cachedNormals[locId], distThresh);
+		}
+		else isValidPoint = computePerPointGH_Depth_Ab<shortIteration, rotationOnly>(A, b, x, y, depth[locId], viewImageSize, viewIntrinsics, sceneImageSize,
+			sceneIntrinsics, approxInvPose, scenePose, pointsMap, normalsMap, distThresh);
+
+		if (isValidPoint) cell.AddPoint(A, b, noPara);
+	}
+}
+
+void ITMDepthTracker_CPU::PrepareLevel()
+{
+	pointSelection.Select(viewHierarchyLevel->data->GetData(MEMORYDEVICE_CPU), viewHierarchyLevel->data->noDims, viewHierarchyLevel->intrinsics, maxPointsPerLevel);
+
+	// the correspondences of the last level or frame belong to other images
+	hasCachedCorrespondences = false;
+}
+
 int ITMDepthTracker_CPU::ComputeGandH(float &f, float *nabla, float *hessian, Matrix4f approxInvPose)
 {
 	Vector4f *pointsMap = sceneHierarchyLevel->pointsMap->GetData(MEMORYDEVICE_CPU);
@@ -27,54 +192,107 @@ int ITMDepthTracker_CPU::ComputeGandH(float &f, float *nabla, float *hessian, Ma
 
 	bool shortIteration = (iterationType == TRACKER_ITERATION_ROTATION) || (iterationType == TRACKER_ITERATION_TRANSLATION);
 
-	float sumHessian[6 * 6], sumNabla[6], sumF; int noValidPoints;
-	int noPara = shortIteration ? 3 : 6, noParaSQ = shortIteration ? 3 + 2 + 1 : 6 + 5 + 4 + 3 + 2 + 1;
+	int noPara = shortIteration ? 3 : 6;
 
-	noValidPoints = 0; sumF = 0.0f;
-	memset(sumHessian, 0, sizeof(float) * noParaSQ);
-	memset(sumNabla, 0, sizeof(float) * noPara);
+	// find the correspondences again once the pose has moved too far from where they were cached
+	Vector4f *cachedPoints = NULL, *cachedNormals = NULL;
+	bool reuseCorrespondences = false;
 
-	for (int y = 0; y < viewImageSize.y; y++) for (int x = 0; x < viewImageSize.x; x++)
+	if (maxPoseUpdateToReuseCorrespondences > 0.0f)
 	{
-		float localHessian[6 + 5 + 4 + 3 + 2 + 1], localNabla[6], localF = 0;
+		reuseCorrespondences = hasCachedCorrespondences && ComputePoseUpdate(approxInvPose, cachedCorrespondencePose) < maxPoseUpdateToReuseCorrespondences;
 
-		for (int i = 0; i < noPara; i++) localNabla[i] = 0.0f;
-		for (int i = 0; i < noParaSQ; i++) localHessian[i] = 0.0f;
+		if (!reuseCorrespondences)
+		{
+			cachedScenePoints.resize(viewImageSize.x * viewImageSize.y);
+			cachedSceneNormals.resize(viewImageSize.x * viewImageSize.y);
+			approxInvPose.inv(cachedCorrespondencePose);
+			hasCachedCorrespondences = true;
+		}
 
-		bool isValidPoint;
-        
-		switch (iterationType)
+		cachedPoints = &cachedScenePoints[0];
+		cachedNormals = &cachedSceneNormals[0];
+	}
+
+	if (pointSelection.IsActive())
+	{
+		const std::vector<int> &selectedPoints = pointSelection.GetPoints();
+		int noSelectedPoints = (int)selectedPoints.size();
+
+		// each group of selected points is summed into its own cell, and the cells are added up in a fixed order afterwards
+		rowCells.assign((noSelectedPoints + noSelectedPointsPerCell - 1) / noSelectedPointsPerCell, ITMTrackerAccuCell());
+		int noCells = (int)rowCells.size();
+
+#ifdef WITH_OPENMP
+		#pragma omp parallel for
+#endif
+		for (int cellId = 0; cellId < noCells; cellId++)
 		{
-		case TRACKER_ITERATION_ROTATION:
-			isValidPoint = computePerPointGH_Depth<true, true>(localNabla, localHessian, localF, x, y, depth[x + y * viewImageSize.x], viewImageSize,
-				viewIntrinsics, sceneImageSize, sceneIntrinsics, approxInvPose, scenePose, pointsMap, normalsMap, distThresh[levelId]);
-			break;
-		case TRACKER_ITERATION_TRANSLATION:
-			isValidPoint = computePerPointGH_Depth<true, false>(localNabla, localHessian, localF, x, y, depth[x + y * viewImageSize.x], viewImageSize,
-				viewIntrinsics, sceneImageSize, sceneIntrinsics, approxInvPose, scenePose, pointsMap, normalsMap, distThresh[levelId]);
-			break;
-		case TRACKER_ITERATION_BOTH:
-			isValidPoint = computePerPointGH_Depth<false, false>(localNabla, localHessian, localF, x, y, depth[x + y * viewImageSize.x], viewImageSize,
-				viewIntrinsics, sceneImageSize, sceneIntrinsics, approxInvPose, scenePose, pointsMap, normalsMap, distThresh[levelId]);
-			break;
-		default:
-			isValidPoint = false;
-			break;
+			const int *pointIds = &selectedPoints[cellId * noSelectedPointsPerCell];
+			int noPoints = MIN(noSelectedPointsPerCell, noSelectedPoints - cellId * noSelectedPointsPerCell);
+
+			switch (iterationType)
+			{
+			case TRACKER_ITERATION_ROTATION:
+				computeSelectedGH_Depth<true, true>(rowCells[cellId], pointIds, noPoints, depth, viewImageSize, viewIntrinsics, sceneImageSize, sceneIntrinsics,
+					approxInvPose, scenePose, pointsMap, normalsMap, distThresh[levelId], cachedPoints, cachedNormals, reuseCorrespondences);
+				break;
+			case TRACKER_ITERATION_TRANSLATION:
+				computeSelectedGH_Depth<true, false>(rowCells[cellId], pointIds, noPoints, depth, viewImageSize, viewIntrinsics, sceneImageSize, sceneIntrinsics,
+					approxInvPose, scenePose, pointsMap, normalsMap, distThresh[levelId], cachedPoints, cachedNormals, reuseCorrespondences);
+				break;
+			case TRACKER_ITERATION_BOTH:
+				computeSelectedGH_Depth<false, false>(rowCells[cellId], pointIds, noPoints, depth, viewImageSize, viewIntrinsics, sceneImageSize, sceneIntrinsics,
+					approxInvPose, scenePose, pointsMap, normalsMap, distThresh[levelId], cachedPoints, cachedNormals, reuseCorrespondences);
+				break;
+			default:
+				break;
+			}
 		}
+	}
+	else
+	{
+		// each row is summed into its own cell, and the cells are added up in a fixed order afterwards
+		rowCells.assign(MAX(viewImageSize.y, 1), ITMTrackerAccuCell());
 
-		if (isValidPoint)
+#ifdef WITH_OPENMP
+		#pragma omp parallel for
+#endif
+		for (int y = 0; y < viewImageSize.y; y++)
 		{
-			noValidPoints++; sumF += localF;
-			for (int i = 0; i < noPara; i++) sumNabla[i] += localNabla[i];
-			for (int i = 0; i < noParaSQ; i++) sumHessian[i] += localHessian[i];
+			const float *depthRow = depth + y * viewImageSize.x;
+			Vector4f *cachedPointsRow = cachedPoints != NULL ? cachedPoints + y * viewImageSize.x : NULL;
+			Vector4f *cachedNormalsRow = cachedNormals != NULL ? cachedNormals + y * viewImageSize.x : NULL;
+
+			switch (iterationType)
+			{
+			case TRACKER_ITERATION_ROTATION:
+				computeRowGH_Depth<true, true>(rowCells[y], y, depthRow, viewImageSize, viewIntrinsics, sceneImageSize, sceneIntrinsics,
+					approxInvPose, scenePose, pointsMap, normalsMap, distThresh[levelId], cachedPointsRow, cachedNormalsRow, reuseCorrespondences);
+				break;
+			case TRACKER_ITERATION_TRANSLATION:
+				computeRowGH_Depth<true, false>(rowCells[y], y, depthRow, viewImageSize, viewIntrinsics, sceneImageSize, sceneIntrinsics,
+					approxInvPose, scenePose, pointsMap, normalsMap, distThresh[levelId], cachedPointsRow, cachedNormalsRow, reuseCorrespondences);
+				break;
+			case TRACKER_ITERATION_BOTH:
+				computeRowGH_Depth<false, false>(rowCells[y], y, depthRow, viewImageSize, viewIntrinsics, sceneImageSize, sceneIntrinsics,
+					approxInvPose, scenePose, pointsMap, normalsMap, distThresh[levelId], cachedPointsRow, cachedNormalsRow, reuseCorrespondences);
+				break;
+			default:
+				break;
+			}
 		}
 	}
 
-	for (int r = 0, counter = 0; r < noPara; r++) for (int c = 0; c <= r; c++, counter++) hessian[r + c * 6] = sumHessian[counter];
-	for (int r = 0; r < noPara; ++r) for (int c = r + 1; c < noPara; c++) hessian[r + c * 6] = hessian[c + r * 6];
-	
-	memcpy(nabla, sumNabla, noPara * sizeof(float));
-	f = (noValidPoints > 100) ? sumF / noValidPoints : 1e5f;
+	ITMTrackerAccuCell::Reduce(rowCells);
+	ITMTrackerAccuCell &sum = rowCells[0];
+
+	// with a selection, the sums are scaled to those expected over all points
+	if (pointSelection.IsActive()) sum.Scale(pointSelection.GetPointWeight());
+
+	sum.GetGandH(nabla, hessian, noPara);
+	int noValidPoints = sum.numPoints;
+	f = (noValidPoints > 100) ? sum.f / noValidPoints : 1e5f;
 
 	return noValidPoints;
 }
@@ -3,13 +3,30 @@
 #pragma once
 
 #include "../Interface/ITMDepthTracker.h"
+#include "ITMTrackerPointSelection_CPU.h"
+#include "ITMTrackerReduction_CPU.h"
 
 namespace ITMLib
 {
 	class ITMDepthTracker_CPU : public ITMDepthTracker
 	{
+	private:
+		/// Sums of each image row, or of each group of selected points, reused across iterations
+		std::vector<ITMTrackerAccuCell> rowCells;
+
+		/// Points evaluated at the current level, if their number is limited
+		ITMTrackerPointSelection_CPU pointSelection;
+
+		/// Scene point and normal associated with each view pixel of the current level, with w < 0 where there is none
+		std::vector<Vector4f> cachedScenePoints, cachedSceneNormals;
+
+		/// Pose the cached correspondences were found at, as given by SE3Pose::GetM, and whether there are any for the current level
+		Matrix4f cachedCorrespondencePose;
+		bool hasCachedCorrespondences;
+
 	protected:
 		int ComputeGandH(float &f, float *nabla, float *hessian, Matrix4f approxInvPose);
+		void PrepareLevel();
 
 	public:
 		ITMDepthTracker_CPU(Vector2i imgSize, TrackerIterationType *trackingRegime, int noHierarchyLevels,
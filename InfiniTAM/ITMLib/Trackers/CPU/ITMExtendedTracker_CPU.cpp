@@ -42,6 +42,38 @@ ITMExtendedTracker_CPU::ITMExtendedTracker_CPU(Vector2i imgSize_d,
 
 ITMExtendedTracker_CPU::~ITMExtendedTracker_CPU(void) { }
 
+/// Number of selected points summed into each cell
+static const int noSelectedPointsPerCell = 256;
+
+void ITMExtendedTracker_CPU::PrepareLevel()
+{
+	pointSelection.Select(viewHierarchyLevel_Depth->depth->GetData(MEMORYDEVICE_CPU), viewHierarchyLevel_Depth->depth->noDims, viewHierarchyLevel_Depth->intrinsics, maxPointsPerLevel);
+}
+
+int ITMExtendedTracker_CPU::PrepareCells(const Vector2i &imgSize)
+{
+	// each cell is summed on its own, and the cells are added up in a fixed order afterwards
+	if (pointSelection.IsActive()) rowCells.assign((pointSelection.GetPoints().size() + noSelectedPointsPerCell - 1) / noSelectedPointsPerCell, ITMTrackerAccuCell());
+	else rowCells.assign(MAX(imgSize.y, 1), ITMTrackerAccuCell());
+
+	return (int)rowCells.size();
+}
+
+void ITMExtendedTracker_CPU::GetCellPoints(int cellId, const Vector2i &imgSize, const int *&pointIds, int &noPoints) const
+{
+	if (pointSelection.IsActive())
+	{
+		const std::vector<int> &selectedPoints = pointSelection.GetPoints();
+		pointIds = &selectedPoints[cellId * noSelectedPointsPerCell];
+		noPoints = MIN(noSelectedPointsPerCell, (int)selectedPoints.size() - cellId * noSelectedPointsPerCell);
+	}
+	else
+	{
+		pointIds = NULL;
+		noPoints = imgSize.x;
+	}
+}
+
 int ITMExtendedTracker_CPU::ComputeGandH_Depth(float &f, float *nabla, float *hessian, Matrix4f approxInvPose)
 {
 	Vector4f *pointsMap = sceneHierarchyLevel_Depth->pointsMap->GetData(MEMORYDEVICE_CPU);
@@ -58,95 +90,98 @@ int ITMExtendedTracker_CPU::ComputeGandH_Depth(float &f, float *nabla, float *he
 	bool shortIteration = (currentIterationType == TRACKER_ITERATION_ROTATION)
 						   || (currentIterationType == TRACKER_ITERATION_TRANSLATION);
 
-	float sumHessian[6 * 6], sumNabla[6], sumF; int noValidPoints;
 	int noPara = shortIteration ? 3 : 6, noParaSQ = shortIteration ? 3 + 2 + 1 : 6 + 5 + 4 + 3 + 2 + 1;
 
-	noValidPoints = 0; sumF = 0.0f;
-	memset(sumHessian, 0, sizeof(float) * noParaSQ);
-	memset(sumNabla, 0, sizeof(float) * noPara);
+	int noCells = PrepareCells(viewImageSize);
 
-	for (int y = 0; y < viewImageSize.y; y++) for (int x = 0; x < viewImageSize.x; x++)
+#ifdef WITH_OPENMP
+	#pragma omp parallel for
+#endif
+	for (int cellId = 0; cellId < noCells; cellId++)
 	{
-		float localHessian[6 + 5 + 4 + 3 + 2 + 1], localNabla[6], localF = 0;
+		ITMTrackerAccuCell &cell = rowCells[cellId];
+
+		const int *pointIds; int noPoints;
+		GetCellPoints(cellId, viewImageSize, pointIds, noPoints);
 
-		for (int i = 0; i < noPara; i++) localNabla[i] = 0.0f;
-		for (int i = 0; i < noParaSQ; i++) localHessian[i] = 0.0f;
+		for (int pointId = 0; pointId < noPoints; pointId++)
+		{
+			int x = pointIds != NULL ? pointIds[pointId] % viewImageSize.x : pointId;
+			int y = pointIds != NULL ? pointIds[pointId] / viewImageSize.x : cellId;
 
-		bool isValidPoint;
+			float localHessian[6 + 5 + 4 + 3 + 2 + 1], localNabla[6], localF = 0;
 
-		float depthWeight;
+			for (int i = 0; i < noPara; i++) localNabla[i] = 0.0f;
+			for (int i = 0; i < noParaSQ; i++) localHessian[i] = 0.0f;
 
-		if (framesProcessed < 100)
-		{
-			switch (currentIterationType)
+			bool isValidPoint;
+
+			float depthWeight;
+
+			if (framesProcessed < 100)
 			{
-			case TRACKER_ITERATION_ROTATION:
-				isValidPoint = computePerPointGH_exDepth<true, true, false>(localNabla, localHessian, localF, x, y, depth[x + y * viewImageSize.x], depthWeight,
-					viewImageSize, viewIntrinsics, sceneImageSize, sceneIntrinsics, approxInvPose, scenePose, pointsMap, normalsMap, spaceThresh[currentLevelId],
-					viewFrustum_min, viewFrustum_max, tukeyCutOff, framesToSkip, framesToWeight);
-				break;
-			case TRACKER_ITERATION_TRANSLATION:
-				isValidPoint = computePerPointGH_exDepth<true, false, false>(localNabla, localHessian, localF, x, y, depth[x + y * viewImageSize.x], depthWeight,
-					viewImageSize, viewIntrinsics, sceneImageSize, sceneIntrinsics, approxInvPose, scenePose, pointsMap, normalsMap, spaceThresh[currentLevelId],
-					viewFrustum_min, viewFrustum_max, tukeyCutOff, framesToSkip, framesToWeight);
-				break;
-			case TRACKER_ITERATION_BOTH:
-				isValidPoint = computePerPointGH_exDepth<false, false, false>(localNabla, localHessian, localF, x, y, depth[x + y * viewImageSize.x], depthWeight,
-					viewImageSize, viewIntrinsics, sceneImageSize, sceneIntrinsics, approxInvPose, scenePose, pointsMap, normalsMap, spaceThresh[currentLevelId],
-					viewFrustum_min, viewFrustum_max, tukeyCutOff, framesToSkip, framesToWeight);
-				break;
-			default:
-				isValidPoint = false;
-				break;
+				switch (currentIterationType)
+				{
+				case TRACKER_ITERATION_ROTATION:
+					isValidPoint = computePerPointGH_exDepth<true, true, false>(localNabla, localHessian, localF, x, y, depth[x + y * viewImageSize.x], depthWeight,
+						viewImageSize, viewIntrinsics, sceneImageSize, sceneIntrinsics, approxInvPose, scenePose, pointsMap, normalsMap, spaceThresh[currentLevelId],
+						viewFrustum_min, viewFrustum_max, tukeyCutOff, framesToSkip, framesToWeight);
+					break;
+				case TRACKER_ITERATION_TRANSLATION:
+					isValidPoint = computePerPointGH_exDepth<true, false, false>(localNabla, localHessian, localF, x, y, depth[x + y * viewImageSize.x], depthWeight,
+						viewImageSize, viewIntrinsics, sceneImageSize, sceneIntrinsics, approxInvPose, scenePose, pointsMap, normalsMap, spaceThresh[currentLevelId],
+						viewFrustum_min, viewFrustum_max, tukeyCutOff, framesToSkip, framesToWeight);
+					break;
+				case TRACKER_ITERATION_BOTH:
+					isValidPoint = computePerPointGH_exDepth<false, false, false>(localNabla, localHessian, localF, x, y, depth[x + y * viewImageSize.x], depthWeight,
+						viewImageSize, viewIntrinsics, sceneImageSize, sceneIntrinsics, approxInvPose, scenePose, pointsMap, normalsMap, spaceThresh[currentLevelId],
+						viewFrustum_min, viewFrustum_max, tukeyCutOff, framesToSkip, framesToWeight);
+					break;
+				default:
+					isValidPoint = false;
+					break;
+				}
 			}
-		}
-		else
-		{
-			switch (currentIterationType)
+			else
 			{
-			case TRACKER_ITERATION_ROTATION:
-				isValidPoint = computePerPointGH_exDepth<true, true, true>(localNabla, localHessian, localF, x, y, depth[x + y * viewImageSize.x], depthWeight,
-					viewImageSize, viewIntrinsics, sceneImageSize, sceneIntrinsics, approxInvPose, scenePose, pointsMap, normalsMap, spaceThresh[currentLevelId],
-					viewFrustum_min, viewFrustum_max, tukeyCutOff, framesToSkip, framesToWeight);
-				break;
-			case TRACKER_ITERATION_TRANSLATION:
-				isValidPoint = computePerPointGH_exDepth<true, false, true>(localNabla, localHessian, localF, x, y, depth[x + y * viewImageSize.x], depthWeight,
-					viewImageSize, viewIntrinsics, sceneImageSize, sceneIntrinsics, approxInvPose, scenePose, pointsMap, normalsMap, spaceThresh[currentLevelId],
-					viewFrustum_min, viewFrustum_max, tukeyCutOff, framesToSkip, framesToWeight);
-				break;
-			case TRACKER_ITERATION_BOTH:
-				isValidPoint = computePerPointGH_exDepth<false, false, true>(localNabla, localHessian, localF, x, y, depth[x + y * viewImageSize.x], depthWeight,
-					viewImageSize, viewIntrinsics, sceneImageSize, sceneIntrinsics, approxInvPose, scenePose, pointsMap, normalsMap, spaceThresh[currentLevelId],
-					viewFrustum_min, viewFrustum_max, tukeyCutOff, framesToSkip, framesToWeight);
-				break;
-			default:
-				isValidPoint = false;
-				break;
+				switch (currentIterationType)
+				{
+				case TRACKER_ITERATION_ROTATION:
+					isValidPoint = computePerPointGH_exDepth<true, true, true>(localNabla, localHessian, localF, x, y, depth[x + y * viewImageSize.x], depthWeight,
+						viewImageSize, viewIntrinsics, sceneImageSize, sceneIntrinsics, approxInvPose, scenePose, pointsMap, normalsMap, spaceThresh[currentLevelId],
+						viewFrustum_min, viewFrustum_max, tukeyCutOff, framesToSkip, framesToWeight);
+					break;
+				case TRACKER_ITERATION_TRANSLATION:
+					isValidPoint = computePerPointGH_exDepth<true, false, true>(localNabla, localHessian, localF, x, y, depth[x + y * viewImageSize.x], depthWeight,
+						viewImageSize, viewIntrinsics, sceneImageSize, sceneIntrinsics, approxInvPose, scenePose, pointsMap, normalsMap, spaceThresh[currentLevelId],
+						viewFrustum_min, viewFrustum_max, tukeyCutOff, framesToSkip, framesToWeight);
+					break;
+				case TRACKER_ITERATION_BOTH:
+					isValidPoint = computePerPointGH_exDepth<false, false, true>(localNabla, localHessian, localF, x, y, depth[x + y * viewImageSize.x], depthWeight,
+						viewImageSize, viewIntrinsics, sceneImageSize, sceneIntrinsics, approxInvPose, scenePose, pointsMap, normalsMap, spaceThresh[currentLevelId],
+						viewFrustum_min, viewFrustum_max, tukeyCutOff, framesToSkip, framesToWeight);
+					break;
+				default:
+					isValidPoint = false;
+					break;
+				}
 			}
-		}
 
-		if (isValidPoint)
-		{
-			noValidPoints++;
-			sumF += localF;
-			for (int i = 0; i < noPara; i++) sumNabla[i] += localNabla[i];
-			for (int i = 0; i < noParaSQ; i++) sumHessian[i] += localHessian[i];
+			if (isValidPoint) cell.Add(localF, localNabla, localHessian, noPara, noParaSQ);
 		}
 	}
 
-	// Copy the lower triangular part of the matrix.
-	for (int r = 0, counter = 0; r < noPara; r++)
-		for (int c = 0; c <= r; c++, counter++)
-			hessian[r + c * 6] = sumHessian[counter];
+	ITMTrackerAccuCell::Reduce(rowCells);
+	ITMTrackerAccuCell &sum = rowCells[0];
 
-	// Transpose to fill the upper triangle.
-	for (int r = 0; r < noPara; ++r)
-		for (int c = r + 1; c < noPara; c++)
-			hessian[r + c * 6] = hessian[c + r * 6];
+	// with a selection, the sums are scaled to those expected over all points
+	if (pointSelection.IsActive()) sum.Scale(pointSelection.GetPointWeight());
 
-	memcpy(nabla, sumNabla, noPara * sizeof(float));
+	// Copy the lower triangular part of the matrix and transpose it to fill the upper triangle.
+	sum.GetGandH(nabla, hessian, noPara);
 
-	f = sumF;
+	f = sum.f;
+	int noValidPoints = sum.numPoints;
 
 	return noValidPoints;
 }
@@ -169,124 +204,129 @@ int ITMExtendedTracker_CPU::ComputeGandH_RGB(float &f, float *nabla, float *hess
 	bool shortIteration = (currentIterationType == TRACKER_ITERATION_ROTATION)
 						   || (currentIterationType == TRACKER_ITERATION_TRANSLATION);
 
-	float sumHessian[6 * 6], sumNabla[6], sumF;
-	int noValidPoints;
 	int noPara = shortIteration ? 3 : 6, noParaSQ = shortIteration ? 3 + 2 + 1 : 6 + 5 + 4 + 3 + 2 + 1;
 
-	noValidPoints = 0; sumF = 0.0f;
-	memset(sumHessian, 0, sizeof(float) * noParaSQ);
-	memset(sumNabla, 0, sizeof(float) * noPara);
+	// the same for all points
+	Matrix4f scenePose_rgb = depthToRGBTransform * scenePose;
 
-	for (int y = 0; y < viewImageSize_depth.y; y++) for (int x = 0; x < viewImageSize_depth.x; x++)
-	{
-		float localHessian[6 + 5 + 4 + 3 + 2 + 1], localNabla[6], localF = 0;
+	int noCells = PrepareCells(viewImageSize_depth);
 
-		for (int i = 0; i < noPara; i++) localNabla[i] = 0.0f;
-		for (int i = 0; i < noParaSQ; i++) localHessian[i] = 0.0f;
+#ifdef WITH_OPENMP
+	#pragma omp parallel for
+#endif
+	for (int cellId = 0; cellId < noCells; cellId++)
+	{
+		ITMTrackerAccuCell &cell = rowCells[cellId];
 
-		bool isValidPoint = false;
+		const int *pointIds; int noPoints;
+		GetCellPoints(cellId, viewImageSize_depth, pointIds, noPoints);
 
-		switch (currentIterationType)
+		for (int pointId = 0; pointId < noPoints; pointId++)
 		{
-		case TRACKER_ITERATION_ROTATION:
-			isValidPoint = computePerPointGH_exRGB_inv_Ab<true, true>(
-					localF,
-					localNabla,
-					localHessian,
-					x,
-					y,
-					points_curr,
-					intensities_current,
-					intensities_prev,
-					gradients,
-					viewImageSize_depth,
-					viewImageSize_rgb,
-					projParams_depth,
-					projParams_rgb,
-					approxInvPose,
-					depthToRGBTransform * scenePose,
-					colourThresh[currentLevelId],
-					minColourGradient,
-					viewFrustum_min,
-					viewFrustum_max,
-					tukeyCutOff
-					);
-			break;
-		case TRACKER_ITERATION_TRANSLATION:
-			isValidPoint = computePerPointGH_exRGB_inv_Ab<true, false>(
-					localF,
-					localNabla,
-					localHessian,
-					x,
-					y,
-					points_curr,
-					intensities_current,
-					intensities_prev,
-					gradients,
-					viewImageSize_depth,
-					viewImageSize_rgb,
-					projParams_depth,
-					projParams_rgb,
-					approxInvPose,
-					depthToRGBTransform * scenePose,
-					colourThresh[currentLevelId],
-					minColourGradient,
-					viewFrustum_min,
-					viewFrustum_max,
-					tukeyCutOff
-					);
-			break;
-		case TRACKER_ITERATION_BOTH:
-			isValidPoint = computePerPointGH_exRGB_inv_Ab<false, false>(
-					localF,
-					localNabla,
-					localHessian,
-					x,
-					y,
-					points_curr,
-					intensities_current,
-					intensities_prev,
-					gradients,
-					viewImageSize_depth,
-					viewImageSize_rgb,
-					projParams_depth,
-					projParams_rgb,
-					approxInvPose,
-					depthToRGBTransform * scenePose,
-					colourThresh[currentLevelId],
-					minColourGradient,
-					viewFrustum_min,
-					viewFrustum_max,
-					tukeyCutOff
-					);
-			break;
-		default:
-			isValidPoint = false;
-			break;
-		}
+			int x = pointIds != NULL ? pointIds[pointId] % viewImageSize_depth.x : pointId;
+			int y = pointIds != NULL ? pointIds[pointId] / viewImageSize_depth.x : cellId;
 
-		if (isValidPoint)
-		{
-			noValidPoints++;
-			sumF += localF;
-			for (int i = 0; i < noPara; i++) sumNabla[i] += localNabla[i];
-			for (int i = 0; i < noParaSQ; i++) sumHessian[i] += localHessian[i];
+			float localHessian[6 + 5 + 4 + 3 + 2 + 1], localNabla[6], localF = 0;
+
+			for (int i = 0; i < noPara; i++) localNabla[i] = 0.0f;
+			for (int i = 0; i < noParaSQ; i++) localHessian[i] = 0.0f;
+
+			bool isValidPoint = false;
+
+			switch (currentIterationType)
+			{
+			case TRACKER_ITERATION_ROTATION:
+				isValidPoint = computePerPointGH_exRGB_inv_Ab<true, true>(
+						localF,
+						localNabla,
+						localHessian,
+						x,
+						y,
+						points_curr,
+						intensities_current,
+						intensities_prev,
+						gradients,
+						viewImageSize_depth,
+						viewImageSize_rgb,
+						projParams_depth,
+						projParams_rgb,
+						approxInvPose,
+						scenePose_rgb,
+						colourThresh[currentLevelId],
+						minColourGradient,
+						viewFrustum_min,
+						viewFrustum_max,
+						tukeyCutOff
+						);
+				break;
+			case TRACKER_ITERATION_TRANSLATION:
+				isValidPoint = computePerPointGH_exRGB_inv_Ab<true, false>(
+						localF,
+						localNabla,
+						localHessian,
+						x,
+						y,
+						points_curr,
+						intensities_current,
+						intensities_prev,
+						gradients,
+						viewImageSize_depth,
+						viewImageSize_rgb,
+						projParams_depth,
+						projParams_rgb,
+						approxInvPose,
+						scenePose_rgb,
+						colourThresh[currentLevelId],
+						minColourGradient,
+						viewFrustum_min,
+						viewFrustum_max,
+						tukeyCutOff
+						);
+				break;
+			case TRACKER_ITERATION_BOTH:
+				isValidPoint = computePerPointGH_exRGB_inv_Ab<false, false>(
+						localF,
+						localNabla,
+						localHessian,
+						x,
+						y,
+						points_curr,
+						intensities_current,
+						intensities_prev,
+						gradients,
+						viewImageSize_depth,
+						viewImageSize_rgb,
+						projParams_depth,
+						projParams_rgb,
+						approxInvPose,
+						scenePose_rgb,
+						colourThresh[currentLevelId],
+						minColourGradient,
+						viewFrustum_min,
+						viewFrustum_max,
+						tukeyCutOff
+						);
+				break;
+			default:
+				isValidPoint = false;
+				break;
+			}
+
+			if (isValidPoint) cell.Add(localF, localNabla, localHessian, noPara, noParaSQ);
 		}
 	}
 
-	// Copy the lower triangular part of the matrix.
-	for (int r = 0, counter = 0; r < noPara; r++)
-		for (int c = 0; c <= r; c++, counter++)
-			hessian[r + c * 6] = sumHessian[counter];
+	ITMTrackerAccuCell::Reduce(rowCells);
+	ITMTrackerAccuCell &sum = rowCells[0];
 
-	// Transpose to fill the upper triangle.
-	for (int r = 0; r < noPara; ++r)
-		for (int c = r + 1; c < noPara; c++)
-			hessian[r + c * 6] = hessian[c + r * 6];
+	// with a selection, the sums are scaled to those expected over all points
+	if (pointSelection.IsActive()) sum.Scale(pointSelection.GetPointWeight());
 
-	memcpy(nabla, sumNabla, noPara * sizeof(float));
+	// Copy the lower triangular part of the matrix and transpose it to fill the upper triangle.
+	sum.GetGandH(nabla, hessian, noPara);
 
-	f = sumF;
+	f = sum.f;
+	int noValidPoints = sum.numPoints;
 
 	return noValidPoints;
 }
@@ -310,6 +350,9 @@ void ITMExtendedTracker_CPU::ProjectCurrentIntensityFrame(ITMFloat4Image *points
 	Vector4f *pointsOut = points_out->GetData(MEMORYDEVICE_CPU);
 	float *intensityOut = intensity_out->GetData(MEMORYDEVICE_CPU);
 
+#ifdef WITH_OPENMP
+	#pragma omp parallel for
+#endif
 	for (int y = 0; y < imageSize_depth.y; y++) for (int x = 0; x < imageSize_depth.x; x++)
 		projectPoint_exRGB(x, y, pointsOut, intensityOut, intensityIn, depths, imageSize_rgb, imageSize_depth, intrinsics_rgb, intrinsics_depth, scenePose);
 }
@@ -3,14 +3,30 @@
 #pragma once
 
 #include "../Interface/ITMExtendedTracker.h"
+#include "ITMTrackerPointSelection_CPU.h"
+#include "ITMTrackerReduction_CPU.h"
 
 namespace ITMLib
 {
 	class ITMExtendedTracker_CPU : public ITMExtendedTracker
 	{
+	private:
+		/// Sums of each image row, or of each group of selected points, reused across iterations
+		std::vector<ITMTrackerAccuCell> rowCells;
+
+		/// Points evaluated at the current level, if their number is limited
+		ITMTrackerPointSelection_CPU pointSelection;
+
+		/// Sets up one cell per image row, or per group of selected points
+		int PrepareCells(const Vector2i &imgSize);
+
+		/// Pixels summed into a cell, either listed in pointIds or, if that is NULL, the row cellId
+		void GetCellPoints(int cellId, const Vector2i &imgSize, const int *&pointIds, int &noPoints) const;
+
 	protected:
 		int ComputeGandH_Depth(float &f, float *nabla, float *hessian, Matrix4f approxInvPose);
 		int ComputeGandH_RGB(float &f, float *nabla, float *hessian, Matrix4f approxInvPose);
+		void PrepareLevel();
 		void ProjectCurrentIntensityFrame(ITMFloat4Image *points_out,
 										  ITMFloatImage *intensity_out,
 										  const ITMFloatImage *intensity_in,
@@ -0,0 +1,118 @@
+// Copyright 2014-2017 Oxford University Innovation Limited and the authors of InfiniTAM
+
+#include "ITMTrackerPointSelection_CPU.h"
+
+using namespace ITMLib;
+
+/// The x and y components of the normals are binned on a regular grid with this many cells per axis
+static const int noBinsPerAxis = 8;
+static const int noBins = noBinsPerAxis * noBinsPerAxis;
+
+/// Bin of the surface normal at a pixel, estimated from its right and lower neighbours, or -1 if it has none
+static inline int computeNormalBin(const float *depth, int x, int y, const Vector2i &imgSize, const Vector4f &intrinsics)
+{
+	if (x + 1 >= imgSize.x || y + 1 >= imgSize.y) return -1;
+
+	int locId = x + y * imgSize.x;
+	float d = depth[locId], d_x = depth[locId + 1], d_y = depth[locId + imgSize.x];
+	if (d <= 0.0f || d_x <= 0.0f || d_y <= 0.0f) return -1;
+
+	Vector3f p(d * (x - intrinsics.z) / intrinsics.x, d * (y - intrinsics.w) / intrinsics.y, d);
+	Vector3f p_x(d_x * (x + 1 - intrinsics.z) / intrinsics.x, d_x * (y - intrinsics.w) / intrinsics.y, d_x);
+	Vector3f p_y(d_y * (x - intrinsics.z) / intrinsics.x, d_y * (y + 1 - intrinsics.w) / intrinsics.y, d_y);
+
+	Vector3f normal = cross(p_x - p, p_y - p);
+	float norm = sqrtf(dot(normal, normal));
+	if (norm <= 0.0f) return -1;
+
+	// orient the normal towards the camera, its direction is then given by the x and y components
+	normal /= normal.z > 0.0f ? -norm : norm;
+
+	int binX = CLAMP((int)((normal.x + 1.0f) * 0.5f * noBinsPerAxis), 0, noBinsPerAxis - 1);
+	int binY = CLAMP((int)((normal.y + 1.0f) * 0.5f * noBinsPerAxis), 0, noBinsPerAxis - 1);
+
+	return binX + binY * noBinsPerAxis;
+}
+
+void ITMTrackerPointSelection_CPU::Select(const float *depth, const Vector2i &imgSize, const Vector4f &intrinsics, int maxPoints)
+{
+	isActive = false;
+	pointWeight = 1.0f;
+	selectedPoints.clear();
+
+	int noPixels = imgSize.x * imgSize.y;
+	if (maxPoints <= 0 || noPixels <= maxPoints) return;
+
+	pointBins.resize(noPixels);
+	noRowCandidates.assign(imgSize.y, 0);
+
+#ifdef WITH_OPENMP
+	#pragma omp parallel for
+#endif
+	for (int y = 0; y < imgSize.y; y++)
+	{
+		int noCandidates = 0;
+		for (int x = 0; x < imgSize.x; x++)
+		{
+			int bin = computeNormalBin(depth, x, y, imgSize, intrinsics);
+			pointBins[x + y * imgSize.x] = bin;
+			if (bin >= 0) noCandidates++;
+		}
+		noRowCandidates[y] = noCandidates;
+	}
+
+	int noCandidates = 0, noValidDepths = 0;
+	int binSizes[noBins], binOffsets[noBins];
+	for (int bin = 0; bin < noBins; bin++) binSizes[bin] = 0;
+
+	for (int y = 0; y < imgSize.y; y++) noCandidates += noRowCandidates[y];
+	if (noCandidates <= maxPoints) return;
+
+	for (int locId = 0; locId < noPixels; locId++)
+	{
+		if (depth[locId] > 0.0f) noValidDepths++;
+		if (pointBins[locId] >= 0) binSizes[pointBins[locId]]++;
+	}
+
+	// counting sort of the candidates by bin, keeping them in raster order within each bin
+	for (int bin = 0, offset = 0; bin < noBins; bin++) { binOffsets[bin] = offset; offset += binSizes[bin]; }
+
+	binnedPoints.resize(noCandidates);
+	{
+		int binEnds[noBins];
+		for (int bin = 0; bin < noBins; bin++) binEnds[bin] = binOffsets[bin];
+		for (int locId = 0; locId < noPixels; locId++) if (pointBins[locId] >= 0) binnedPoints[binEnds[pointBins[locId]]++] = locId;
+	}
+
+	// visit the bins from the smallest one, each taking its fair share of what the smaller ones left over
+	int binOrder[noBins], noNonEmptyBins = 0;
+	for (int bin = 0; bin < noBins; bin++)
+	{
+		if (binSizes[bin] == 0) continue;
+
+		int pos = noNonEmptyBins++;
+		for (; pos > 0 && binSizes[binOrder[pos - 1]] > binSizes[bin]; pos--) binOrder[pos] = binOrder[pos - 1];
+		binOrder[pos] = bin;
+	}
+
+	// mark the chosen points in pointBins, so that they can be listed in raster order
+	int noPointsLeft = maxPoints;
+	for (int orderId = 0; orderId < noNonEmptyBins; orderId++)
+	{
+		int bin = binOrder[orderId], binSize = binSizes[bin];
+		int quota = MIN(binSize, noPointsLeft / (noNonEmptyBins - orderId));
+		noPointsLeft -= quota;
+
+		for (int pointId = 0; pointId < quota; pointId++)
+		{
+			long long offset = ((long long)(2 * pointId + 1) * binSize) / (2 * quota);
+			pointBins[binnedPoints[binOffsets[bin] + (int)offset]] = noBins;
+		}
+	}
+
+	selectedPoints.reserve(maxPoints);
+	for (int locId = 0; locId < noPixels; locId++) if (pointBins[locId] == noBins) selectedPoints.push_back(locId);
+
+	pointWeight = (float)noValidDepths / (float)selectedPoints.size();
+	isActive = true;
+}
@@ -0,0 +1,56 @@
+// Copyright 2014-2017 Oxford University Innovation Limited and the authors of InfiniTAM
+
+#pragma once
+
+#include "../../Utils/ITMMath.h"
+
+#include <vector>
+
+namespace ITMLib
+{
+	/** \brief
+	    Chooses a fixed budget of pixels of a depth image to be
+	    evaluated by the trackers, by normal-space sampling: the
+	    pixels are binned by the direction of their surface normal
+	    and the budget is spread as evenly as possible over the
+	    bins, so that the few points that constrain rarely seen
+	    directions are kept while large flat areas are thinned out.
+	    Within a bin the points are taken at regular intervals in
+	    raster order, so the selection is deterministic and spread
+	    over the image.
+
+	    Each selected point stands in for GetPointWeight() valid
+	    pixels, which lets the trackers scale their sums back to
+	    those of the full image.
+	*/
+	class ITMTrackerPointSelection_CPU
+	{
+	private:
+		std::vector<int> selectedPoints;
+		std::vector<int> pointBins;
+		std::vector<int> binnedPoints;
+		std::vector<int> noRowCandidates;
+
+		float pointWeight;
+		bool isActive;
+
+	public:
+		/** Selects at most maxPoints pixels of the depth image. If
+		    the image has no more valid pixels than that, or maxPoints
+		    is not positive, the selection is disabled and all pixels
+		    should be evaluated.
+		*/
+		void Select(const float *depth, const Vector2i &imgSize, const Vector4f &intrinsics, int maxPoints);
+
+		/// Whether a selection is in use for the current level
+		bool IsActive() const { return isActive; }
+
+		/// Indices of the selected pixels, in increasing order
+		const std::vector<int>& GetPoints() const { return selectedPoints; }
+
+		/// Number of valid pixels represented by each selected one
+		float GetPointWeight() const { return pointWeight; }
+
+		ITMTrackerPointSelection_CPU(void) : pointWeight(1.0f), isActive(false) { }
+	};
+}
@@ -0,0 +1,80 @@
+// Copyright 2014-2017 Oxford University Innovation Limited and the authors of InfiniTAM
+
+#pragma once
+
+#include "../../Utils/ITMMath.h"
+
+#include <string.h>
+#include <vector>
+
+namespace ITMLib
+{
+	/** \brief
+	    Sums of the per-point terms of one Gauss-Newton step on the
+	    CPU, with the Hessian stored as its lower triangle.
+
+	    The trackers sum each image row into a cell of its own, in
+	    parallel, and then add up the cells pairwise in a fixed
+	    order with Reduce. The result therefore does not depend on
+	    the number of threads.
+	*/
+	struct ITMTrackerAccuCell
+	{
+		int numPoints;
+		float f;
+		float g[6];
+		float h[6 + 5 + 4 + 3 + 2 + 1];
+
+		ITMTrackerAccuCell() { memset(this, 0, sizeof(ITMTrackerAccuCell)); }
+
+		void Add(float localF, const float *localNabla, const float *localHessian, int noPara, int noParaSQ)
+		{
+			numPoints++; f += localF;
+			for (int i = 0; i < noPara; i++) g[i] += localNabla[i];
+			for (int i = 0; i < noParaSQ; i++) h[i] += localHessian[i];
+		}
+
+		/// Adds the terms of a single point from its Jacobian row A and residual b
+		void AddPoint(const float *A, float b, int noPara)
+		{
+			numPoints++; f += b * b;
+			for (int r = 0, counter = 0; r < noPara; r++)
+			{
+				g[r] += b * A[r];
+				for (int c = 0; c <= r; c++, counter++) h[counter] += A[r] * A[c];
+			}
+		}
+
+		void Add(const ITMTrackerAccuCell &other)
+		{
+			numPoints += other.numPoints; f += other.f;
+			for (int i = 0; i < 6; i++) g[i] += other.g[i];
+			for (int i = 0; i < 6 + 5 + 4 + 3 + 2 + 1; i++) h[i] += other.h[i];
+		}
+
+		/// Scales the sums as if every point had been counted weight times
+		void Scale(float weight)
+		{
+			numPoints = (int)(numPoints * weight + 0.5f); f *= weight;
+			for (int i = 0; i < 6; i++) g[i] *= weight;
+			for (int i = 0; i < 6 + 5 + 4 + 3 + 2 + 1; i++) h[i] *= weight;
+		}
+
+		/// Adds up the cells as a binary tree over their indices, leaving the total in the first one
+		static void Reduce(std::vector<ITMTrackerAccuCell> &cells)
+		{
+			size_t noCells = cells.size();
+			for (size_t stride = 1; stride < noCells; stride *= 2)
+				for (size_t cellId = 0; cellId + stride < noCells; cellId += 2 * stride) cells[cellId].Add(cells[cellId + stride]);
+		}
+
+		/// Writes the full symmetric noPara x noPara Hessian, with a row stride of 6, and the gradient
+		void GetGandH(float *nabla, float *hessian, int noPara) const
+		{
+			for (int r = 0, counter = 0; r < noPara; r++) for (int c = 0; c <= r; c++, counter++) hessian[r + c * 6] = h[counter];
+			for (int r = 0; r < noPara; ++r) for (int c = r + 1; c < noPara; c++) hessian[r + c * 6] = hessian[c + r * 6];
+
+			memcpy(nabla, g, noPara * sizeof(float));
+		}
+	};
+}
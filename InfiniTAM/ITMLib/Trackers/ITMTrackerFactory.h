@@ -221,6 +221,10 @@ namespace ITMLib
 		float failureDetectorThd = 3.0f;
 		int numIterationsCoarse = 10;
 		int numIterationsFine = 2;
+		int maxPointsPerLevel = 0;
+		float minRelativeDecrease = 0.0f;
+		float maxPoseUpdateToSkip = 0.0f;
+		float maxPoseUpdateToReuseCorrespondences = 0.0f;
 
 		int verbose = 0;
 		if (cfg.getProperty("help") != NULL) if (verbose < 10) verbose = 10;
@@ -233,6 +237,10 @@ namespace ITMLib
 		cfg.parseIntProperty("numiterC", "maximum number of iterations at coarsest level", numIterationsCoarse, verbose);
 		cfg.parseIntProperty("numiterF", "maximum number of iterations at finest level", numIterationsFine, verbose);
 		cfg.parseFltProperty("failureDec", "threshold for the failure detection", failureDetectorThd, verbose);
+		cfg.parseIntProperty("maxPoints", "maximum number of points evaluated per level, 0 for all (CPU only)", maxPointsPerLevel, verbose);
+		cfg.parseFltProperty("minDecrease", "relative decrease of the error below which a level stops iterating, 0 to disable", minRelativeDecrease, verbose);
+		cfg.parseFltProperty("skipMotion", "pose correction of the last frame below which rotation and translation only levels are skipped, 0 to disable", maxPoseUpdateToSkip, verbose);
+		cfg.parseFltProperty("cacheMotion", "pose change up to which the correspondences of an earlier iteration are reused, 0 to disable (CPU only)", maxPoseUpdateToReuseCorrespondences, verbose);
 
 		ITMDepthTracker *ret = NULL;
 		switch (deviceType)
@@ -255,6 +263,9 @@ namespace ITMLib
 		if (ret == NULL) DIEWITHEXCEPTION("Failed to make ICP tracker");
 		ret->SetupLevels(numIterationsCoarse, numIterationsFine,
 			outlierDistanceCoarse, outlierDistanceFine);
+		ret->SetupPointSelection(maxPointsPerLevel);
+		ret->SetupAdaptiveIterations(minRelativeDecrease, maxPoseUpdateToSkip);
+		ret->SetupCorrespondenceCaching(maxPoseUpdateToReuseCorrespondences);
 		return ret;
 	}
 
@@ -280,6 +291,9 @@ namespace ITMLib
 		int framesToWeight = 50;
 		int numIterationsCoarse = 20;
 		int numIterationsFine = 20;
+		int maxPointsPerLevel = 0;
+		float minRelativeDecrease = 0.0f;
+		float maxPoseUpdateToSkip = 0.0f;
 
 		int verbose = 0;
 		if (cfg.getProperty("help") != NULL) if (verbose < 10) verbose = 10;
@@ -301,6 +315,9 @@ namespace ITMLib
 		cfg.parseIntProperty("framesToSkip", "number of frames to skip before depth pixel is used for tracking", framesToSkip, verbose);
 		cfg.parseIntProperty("framesToWeight", "number of frames to weight each depth pixel for before using it fully", framesToWeight, verbose);
 		cfg.parseFltProperty("failureDec", "threshold for the failure detection", failureDetectorThd, verbose);
+		cfg.parseIntProperty("maxPoints", "maximum number of points evaluated per level, 0 for all (CPU only)", maxPointsPerLevel, verbose);
+		cfg.parseFltProperty("minDecrease", "relative decrease of the error below which a level stops iterating, 0 to disable", minRelativeDecrease, verbose);
+		cfg.parseFltProperty("skipMotion", "pose correction of the last frame below which rotation and translation only levels are skipped, 0 to disable", maxPoseUpdateToSkip, verbose);
 
 		ITMExtendedTracker *ret = NULL;
 		switch (deviceType)
@@ -353,6 +370,8 @@ namespace ITMLib
 
 		if (ret == NULL) DIEWITHEXCEPTION("Failed to make extended tracker");
 		ret->SetupLevels(numIterationsCoarse, numIterationsFine, outlierSpaceDistanceCoarse, outlierSpaceDistanceFine, outlierColourDistanceCoarse, outlierColourDistanceFine);
+		ret->SetupPointSelection(maxPointsPerLevel);
+		ret->SetupAdaptiveIterations(minRelativeDecrease, maxPoseUpdateToSkip);
 		return ret;
 	}
 
@@ -369,6 +388,10 @@ namespace ITMLib
 		float failureDetectorThd = 3.0f;
 		int numIterationsCoarse = 4;
 		int numIterationsFine = 2;
+		int maxPointsPerLevel = 0;
+		float minRelativeDecrease = 0.0f;
+		float maxPoseUpdateToSkip = 0.0f;
+		float maxPoseUpdateToReuseCorrespondences = 0.0f;
 
 		int verbose = 0;
 		if (cfg.getProperty("help") != NULL) if (verbose < 10) verbose = 10;
@@ -381,6 +404,10 @@ namespace ITMLib
 		cfg.parseIntProperty("numiterC", "maximum number of iterations at coarsest level", numIterationsCoarse, verbose);
 		cfg.parseIntProperty("numiterF", "maximum number of iterations at finest level", numIterationsFine, verbose);
 		cfg.parseFltProperty("failureDec", "threshold for the failure detection", failureDetectorThd, verbose);
+		cfg.parseIntProperty("maxPoints", "maximum number of points evaluated per level, 0 for all (CPU only)", maxPointsPerLevel, verbose);
+		cfg.parseFltProperty("minDecrease", "relative decrease of the error below which a level stops iterating, 0 to disable", minRelativeDecrease, verbose);
+		cfg.parseFltProperty("skipMotion", "pose correction of the last frame below which rotation and translation only levels are skipped, 0 to disable", maxPoseUpdateToSkip, verbose);
+		cfg.parseFltProperty("cacheMotion", "pose change up to which the correspondences of an earlier iteration are reused, 0 to disable (CPU only)", maxPoseUpdateToReuseCorrespondences, verbose);
 
 		ITMDepthTracker *dTracker = NULL;
 		switch (deviceType)
@@ -404,6 +431,9 @@ namespace ITMLib
 		if (dTracker == NULL) DIEWITHEXCEPTION("Failed to make IMU tracker");
 		dTracker->SetupLevels(numIterationsCoarse, numIterationsFine,
 			outlierDistanceCoarse, outlierDistanceFine);
+		dTracker->SetupPointSelection(maxPointsPerLevel);
+		dTracker->SetupAdaptiveIterations(minRelativeDecrease, maxPoseUpdateToSkip);
+		dTracker->SetupCorrespondenceCaching(maxPoseUpdateToReuseCorrespondences);
 
 		ITMCompositeTracker *compositeTracker = new ITMCompositeTracker;
 		compositeTracker->AddTracker(new ITMIMUTracker(imuCalibrator));
@@ -53,18 +53,13 @@ void ITMColorTracker::PrepareForEvaluation(const ITMView *view)
 
 	ITMImageHierarchy<ITMViewHierarchyLevel> *hierarchy = viewHierarchy;
 
+	lowLevelEngine->GradientX(hierarchy->GetLevel(0)->gradientX_rgb, hierarchy->GetLevel(0)->rgb);
+	lowLevelEngine->GradientY(hierarchy->GetLevel(0)->gradientY_rgb, hierarchy->GetLevel(0)->rgb);
+
 	for (int i = 1; i < hierarchy->GetNoLevels(); i++)
 	{
 		ITMViewHierarchyLevel *currentLevel = hierarchy->GetLevel(i), *previousLevel = hierarchy->GetLevel(i - 1);
-		lowLevelEngine->FilterSubsample(currentLevel->rgb, previousLevel->rgb);
-	}
-
-	for (int i = 0; i < hierarchy->GetNoLevels(); i++)
-	{
-		ITMViewHierarchyLevel *currentLevel = hierarchy->GetLevel(i);
-
-		lowLevelEngine->GradientX(currentLevel->gradientX_rgb, currentLevel->rgb);
-		lowLevelEngine->GradientY(currentLevel->gradientY_rgb, currentLevel->rgb);
+		lowLevelEngine->FilterSubsampleWithGradients(currentLevel->rgb, currentLevel->gradientX_rgb, currentLevel->gradientY_rgb, previousLevel->rgb);
 	}
 }
 
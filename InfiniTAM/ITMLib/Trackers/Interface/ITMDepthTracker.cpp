@@ -14,9 +14,15 @@ ITMDepthTracker::ITMDepthTracker(Vector2i imgSize, TrackerIterationType *trackin
 	sceneHierarchy = new ITMImageHierarchy<ITMSceneHierarchyLevel>(imgSize, trackingRegime, noHierarchyLevels, memoryType, true);
 
 	this->noIterationsPerLevel = new int[noHierarchyLevels];
+	this->noIterationsUsedPerLevel = new int[noHierarchyLevels];
 	this->distThresh = new float[noHierarchyLevels];
 
+	for (int levelId = 0; levelId < noHierarchyLevels; levelId++) this->noIterationsUsedPerLevel[levelId] = 0;
+
 	SetupLevels(noHierarchyLevels * 2, 2, 0.01f, 0.002f);
+	SetupPointSelection(0);
+	SetupAdaptiveIterations(0.0f, 0.0f);
+	SetupCorrespondenceCaching(0.0f);
 
 	this->lowLevelEngine = lowLevelEngine;
 
@@ -46,6 +52,7 @@ ITMDepthTracker::~ITMDepthTracker(void)
 	delete this->sceneHierarchy;
 
 	delete[] this->noIterationsPerLevel;
+	delete[] this->noIterationsUsedPerLevel;
 	delete[] this->distThresh;
 
 	delete map;
@@ -213,6 +220,7 @@ void ITMDepthTracker::UpdatePoseQuality(int noValidPoints_old, float *hessian_go
 	float percentageInliers_v2 = (float)noValidPoints_old / (float)noValidPointsMax;
 
 	trackingState->trackerResult = ITMTrackingState::TRACKING_FAILED;
+	trackingState->trackerScore = -1e10f;
 
 	if (noValidPointsMax != 0 && noTotalPoints != 0 && det_norm_v1 > 0 && det_norm_v2 > 0) {
 		Vector4f inputVector(log(det_norm_v1), log(det_norm_v2), finalResidual_v2, percentageInliers_v2);
@@ -223,6 +231,7 @@ void ITMDepthTracker::UpdatePoseQuality(int noValidPoints_old, float *hessian_go
 		map->evaluate(mapped, normalisedVector.v, 4);
 
 		float score = svmClassifier->Classify(mapped);
+		trackingState->trackerScore = score;
 
 		if (score > 0) trackingState->trackerResult = ITMTrackingState::TRACKING_GOOD;
 		else if (score > -10.0f) trackingState->trackerResult = ITMTrackingState::TRACKING_POOR;
@@ -234,6 +243,12 @@ void ITMDepthTracker::TrackCamera(ITMTrackingState *trackingState, const ITMView
 	this->SetEvaluationData(trackingState, view);
 	this->PrepareForEvaluation();
 
+	Matrix4f predictedInvPose = trackingState->pose_d->GetInvM();
+
+	// after a well tracked frame that needed only a small correction, the levels meant for large motions are not needed
+	bool skipPartialLevels = maxPoseUpdateToSkip > 0.0f && trackingState->lastTrackerResult == ITMTrackingState::TRACKING_GOOD &&
+		trackingState->lastPoseUpdate >= 0.0f && trackingState->lastPoseUpdate < maxPoseUpdateToSkip;
+
 	float f_old = 1e10, f_new;
 	int noValidPoints_new;
 	int noValidPoints_old = 0;
@@ -247,8 +262,13 @@ void ITMDepthTracker::TrackCamera(ITMTrackingState *trackingState, const ITMView
 
 	for (int levelId = viewHierarchy->GetNoLevels() - 1; levelId >= 0; levelId--)
 	{
+		noIterationsUsedPerLevel[levelId] = 0;
+
 		this->SetEvaluationParams(levelId);
 		if (iterationType == TRACKER_ITERATION_NONE) continue;
+		if (skipPartialLevels && iterationType != TRACKER_ITERATION_BOTH) continue;
+
+		this->PrepareLevel();
 
 		Matrix4f approxInvPose = trackingState->pose_d->GetInvM();
 		ORUtils::SE3Pose lastKnownGoodPose(*(trackingState->pose_d));
@@ -258,6 +278,8 @@ void ITMDepthTracker::TrackCamera(ITMTrackingState *trackingState, const ITMView
 
 		for (int iterNo = 0; iterNo < noIterationsPerLevel[levelId]; iterNo++)
 		{
+			noIterationsUsedPerLevel[levelId] = iterNo + 1;
+
 			// evaluate error function and gradients
 			noValidPoints_new = this->ComputeGandH(f_new, nabla_new, hessian_new, approxInvPose);
 
@@ -268,6 +290,9 @@ void ITMDepthTracker::TrackCamera(ITMTrackingState *trackingState, const ITMView
 				lambda *= 10.0f;
 			}
 			else {
+				// the error has stopped decreasing noticeably, so the level has converged
+				bool hasStalled = f_old - f_new < minRelativeDecrease * f_old;
+
 				lastKnownGoodPose.SetFrom(trackingState->pose_d);
 				f_old = f_new;
 				noValidPoints_old = noValidPoints_new;
@@ -275,6 +300,8 @@ void ITMDepthTracker::TrackCamera(ITMTrackingState *trackingState, const ITMView
 				for (int i = 0; i < 6 * 6; ++i) hessian_good[i] = hessian_new[i] / noValidPoints_new;
 				for (int i = 0; i < 6; ++i) nabla_good[i] = nabla_new[i] / noValidPoints_new;
 				lambda /= 10.0f;
+
+				if (hasStalled) break;
 			}
 			for (int i = 0; i < 6 * 6; ++i) A[i] = hessian_good[i];
 			for (int i = 0; i < 6; ++i) A[i + i * 6] *= 1.0f + lambda;
@@ -292,4 +319,6 @@ void ITMDepthTracker::TrackCamera(ITMTrackingState *trackingState, const ITMView
 	}
 
 	this->UpdatePoseQuality(noValidPoints_old, hessian_good, f_old);
+
+	trackingState->lastPoseUpdate = ComputePoseUpdate(predictedInvPose, trackingState->pose_d->GetM());
 }
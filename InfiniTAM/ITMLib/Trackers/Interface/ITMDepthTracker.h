@@ -28,6 +28,10 @@ namespace ITMLib
 		ITMTrackingState *trackingState; const ITMView *view;
 
 		int *noIterationsPerLevel;
+		int *noIterationsUsedPerLevel;
+
+		float minRelativeDecrease;
+		float maxPoseUpdateToSkip;
 
 		float terminationThreshold;
 
@@ -48,6 +52,12 @@ namespace ITMLib
 	protected:
 		float *distThresh;
 
+		/// Number of points to evaluate per level, or 0 for all of them
+		int maxPointsPerLevel;
+
+		/// Pose change up to which ComputeGandH may reuse the correspondences it found before, or 0 to always search them
+		float maxPoseUpdateToReuseCorrespondences;
+
 		int levelId;
 		TrackerIterationType iterationType;
 
@@ -57,6 +67,9 @@ namespace ITMLib
 
 		virtual int ComputeGandH(float &f, float *nabla, float *hessian, Matrix4f approxInvPose) = 0;
 
+		/// Called once per level before its iterations, e.g. to choose the points that ComputeGandH evaluates
+		virtual void PrepareLevel() { }
+
 	public:
 		void TrackCamera(ITMTrackingState *trackingState, const ITMView *view);
 
@@ -66,6 +79,38 @@ namespace ITMLib
 
 		void SetupLevels(int numIterCoarse, int numIterFine, float distThreshCoarse, float distThreshFine);
 
+		/** Limits the number of points evaluated at each level. This
+		    is only implemented by the CPU tracker, the others always
+		    use every point.
+		*/
+		void SetupPointSelection(int maxPointsPerLevel) { this->maxPointsPerLevel = maxPointsPerLevel; }
+
+		/** Stops iterating on a level once an iteration reduces the
+		    error by less than the fraction minRelativeDecrease. If the
+		    last frame was tracked well and its pose had to be corrected
+		    by less than maxPoseUpdateToSkip, the levels that estimate
+		    only the rotation or only the translation, which are meant
+		    for large motions, are skipped. A value of 0 disables either.
+		*/
+		void SetupAdaptiveIterations(float minRelativeDecrease, float maxPoseUpdateToSkip)
+		{
+			this->minRelativeDecrease = minRelativeDecrease;
+			this->maxPoseUpdateToSkip = maxPoseUpdateToSkip;
+		}
+
+		/** Lets the iterations on a level reuse the scene points and
+		    normals the view points were associated with, until the
+		    pose has moved by more than maxPoseUpdate from the one they
+		    were found at. A value of 0 disables this. This is only
+		    implemented by the CPU tracker.
+		*/
+		void SetupCorrespondenceCaching(float maxPoseUpdate) { this->maxPoseUpdateToReuseCorrespondences = maxPoseUpdate; }
+
+		/// Number of iterations run on the given level for the last frame, 0 if the level was skipped
+		int GetNoIterationsUsed(int levelId) const { return noIterationsUsedPerLevel[levelId]; }
+
+		int GetNoHierarchyLevels() const { return viewHierarchy->GetNoLevels(); }
+
 		ITMDepthTracker(Vector2i imgSize, TrackerIterationType *trackingRegime, int noHierarchyLevels,
 			float terminationThreshold, float failureDetectorThreshold, 
 			const ITMLowLevelEngine *lowLevelEngine, MemoryDeviceType memoryType);
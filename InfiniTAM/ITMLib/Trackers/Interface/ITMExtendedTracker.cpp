@@ -73,10 +73,15 @@ ITMExtendedTracker::ITMExtendedTracker(Vector2i imgSize_d,
 	}
 
 	this->noIterationsPerLevel = new int[noHierarchyLevels];
+	this->noIterationsUsedPerLevel = new int[noHierarchyLevels];
 	this->spaceThresh = new float[noHierarchyLevels];
 	this->colourThresh = new float[noHierarchyLevels];
 
+	for (int levelId = 0; levelId < noHierarchyLevels; levelId++) this->noIterationsUsedPerLevel[levelId] = 0;
+
 	SetupLevels(noHierarchyLevels * 2, 2, 0.01f, 0.002f, 0.1f, 0.02f);
+	SetupPointSelection(0);
+	SetupAdaptiveIterations(0.0f, 0.0f);
 
 	this->lowLevelEngine = lowLevelEngine;
 
@@ -118,6 +123,7 @@ ITMExtendedTracker::~ITMExtendedTracker(void)
 	delete projectedIntensityHierarchy;
 
 	delete[] noIterationsPerLevel;
+	delete[] noIterationsUsedPerLevel;
 	delete[] spaceThresh;
 	delete[] colourThresh;
 
@@ -216,12 +222,11 @@ void ITMExtendedTracker::PrepareForEvaluation()
 			ITMIntensityHierarchyLevel *previousLevel = viewHierarchy_Intensity->GetLevel(i - 1);
 
 			lowLevelEngine->FilterSubsample(currentLevel->intensity_current, previousLevel->intensity_current);
-			lowLevelEngine->FilterSubsample(currentLevel->intensity_prev, previousLevel->intensity_prev);
-
-			currentLevel->intrinsics = previousLevel->intrinsics * 0.5f;
 
 			// Also compute gradients
-			lowLevelEngine->GradientXY(currentLevel->gradients, currentLevel->intensity_prev);
+			lowLevelEngine->FilterSubsampleWithGradients(currentLevel->intensity_prev, currentLevel->gradients, previousLevel->intensity_prev);
+
+			currentLevel->intrinsics = previousLevel->intrinsics * 0.5f;
 		}
 
 		// Project RGB image according to the depth->rgb transform and cache it to speed up the energy computation
@@ -391,6 +396,7 @@ void ITMExtendedTracker::UpdatePoseQuality(int noValidPoints_old, float *hessian
 	float percentageInliers_v2 = (float)noValidPoints_old / (float)noValidPointsMax;
 
 	trackingState->trackerResult = ITMTrackingState::TRACKING_FAILED;
+	trackingState->trackerScore = -1e10f;
 
 	if (noValidPointsMax != 0 && noTotalPoints != 0 && det_norm_v1 > 0 && det_norm_v2 > 0) {
 		Vector4f inputVector(log(det_norm_v1), log(det_norm_v2), finalResidual_v2, percentageInliers_v2);
@@ -401,6 +407,7 @@ void ITMExtendedTracker::UpdatePoseQuality(int noValidPoints_old, float *hessian
 		map->evaluate(mapped, normalisedVector.v, 4);
 
 		float score = svmClassifier->Classify(mapped);
+		trackingState->trackerScore = score;
 
 		if (score > 0) trackingState->trackerResult = ITMTrackingState::TRACKING_GOOD;
 		else if (score > -10.0f) trackingState->trackerResult = ITMTrackingState::TRACKING_POOR;
@@ -415,6 +422,12 @@ void ITMExtendedTracker::TrackCamera(ITMTrackingState *trackingState, const ITMV
 	this->SetEvaluationData(trackingState, view);
 	this->PrepareForEvaluation();
 
+	Matrix4f predictedInvPose = trackingState->pose_d->GetInvM();
+
+	// after a well tracked frame that needed only a small correction, the levels meant for large motions are not needed
+	bool skipPartialLevels = maxPoseUpdateToSkip > 0.0f && trackingState->lastTrackerResult == ITMTrackingState::TRACKING_GOOD &&
+		trackingState->lastPoseUpdate >= 0.0f && trackingState->lastPoseUpdate < maxPoseUpdateToSkip;
+
 	float hessian_good[6 * 6];
 	float nabla_good[6];
 
@@ -430,9 +443,14 @@ void ITMExtendedTracker::TrackCamera(ITMTrackingState *trackingState, const ITMV
 
 	for (int levelId = viewHierarchy_Depth->GetNoLevels() - 1; levelId >= 0; levelId--)
 	{
+		noIterationsUsedPerLevel[levelId] = 0;
+
 		SetEvaluationParams(levelId);
 
 		if (currentIterationType == TRACKER_ITERATION_NONE) continue;
+		if (skipPartialLevels && currentIterationType != TRACKER_ITERATION_BOTH) continue;
+
+		PrepareLevel();
 
 		Matrix4f approxInvPose = trackingState->pose_d->GetInvM();
 		ORUtils::SE3Pose lastKnownGoodPose(*(trackingState->pose_d));
@@ -442,6 +460,8 @@ void ITMExtendedTracker::TrackCamera(ITMTrackingState *trackingState, const ITMV
 
 		for (int iterNo = 0; iterNo < noIterationsPerLevel[levelId]; iterNo++)
 		{
+			noIterationsUsedPerLevel[levelId] = iterNo + 1;
+
 			float hessian_depth[6 * 6], hessian_RGB[6 * 6];
 			float nabla_depth[6], nabla_RGB[6];
 			float f_depth = 0.f, f_RGB = 0.f;
@@ -549,6 +569,9 @@ void ITMExtendedTracker::TrackCamera(ITMTrackingState *trackingState, const ITMV
 			}
 			else
 			{
+				// the error has stopped decreasing noticeably, so the level has converged
+				bool hasStalled = f_old - f_new < minRelativeDecrease * f_old;
+
 				lastKnownGoodPose.SetFrom(trackingState->pose_d);
 				f_old = f_new;
 
@@ -560,6 +583,8 @@ void ITMExtendedTracker::TrackCamera(ITMTrackingState *trackingState, const ITMV
 				noValidPoints_depth_good = noValidPoints_depth;
 				f_depth_good = f_depth;
 				memcpy(hessian_depth_good, hessian_depth, sizeof(hessian_depth));
+
+				if (hasStalled) break;
 			}
 
 			float A[6 * 6];
@@ -581,4 +606,6 @@ void ITMExtendedTracker::TrackCamera(ITMTrackingState *trackingState, const ITMV
 	}
 
 	this->UpdatePoseQuality(noValidPoints_depth_good, hessian_depth_good, f_depth_good);
+
+	trackingState->lastPoseUpdate = ComputePoseUpdate(predictedInvPose, trackingState->pose_d->GetM());
 }
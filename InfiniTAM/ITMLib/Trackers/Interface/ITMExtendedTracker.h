@@ -37,6 +37,10 @@ namespace ITMLib
 		const ITMView *view;
 
 		int *noIterationsPerLevel;
+		int *noIterationsUsedPerLevel;
+
+		float minRelativeDecrease;
+		float maxPoseUpdateToSkip;
 
 		float terminationThreshold;
 
@@ -60,6 +64,9 @@ namespace ITMLib
 		float *spaceThresh;
 		float *colourThresh;
 
+		/// Number of points to evaluate per level, or 0 for all of them
+		int maxPointsPerLevel;
+
 		int currentLevelId;
 		TrackerIterationType currentIterationType;
 
@@ -90,6 +97,9 @@ namespace ITMLib
 												  const Vector4f &intrinsics_rgb,
 												  const Matrix4f &scenePose) = 0;
 
+		/// Called once per level before its iterations, e.g. to choose the points that ComputeGandH_Depth and ComputeGandH_RGB evaluate
+		virtual void PrepareLevel() { }
+
 	public:
 		void TrackCamera(ITMTrackingState *trackingState, const ITMView *view);
 
@@ -99,6 +109,30 @@ namespace ITMLib
 
 		void SetupLevels(int numIterCoarse, int numIterFine, float spaceThreshCoarse, float spaceThreshFine, float colourThreshCoarse, float colourThreshFine);
 
+		/** Limits the number of points evaluated at each level. This
+		    is only implemented by the CPU tracker, the others always
+		    use every point.
+		*/
+		void SetupPointSelection(int maxPointsPerLevel) { this->maxPointsPerLevel = maxPointsPerLevel; }
+
+		/** Stops iterating on a level once an iteration reduces the
+		    error by less than the fraction minRelativeDecrease. If the
+		    last frame was tracked well and its pose had to be corrected
+		    by less than maxPoseUpdateToSkip, the levels that estimate
+		    only the rotation or only the translation, which are meant
+		    for large motions, are skipped. A value of 0 disables either.
+		*/
+		void SetupAdaptiveIterations(float minRelativeDecrease, float maxPoseUpdateToSkip)
+		{
+			this->minRelativeDecrease = minRelativeDecrease;
+			this->maxPoseUpdateToSkip = maxPoseUpdateToSkip;
+		}
+
+		/// Number of iterations run on the given level for the last frame, 0 if the level was skipped
+		int GetNoIterationsUsed(int levelId) const { return noIterationsUsedPerLevel[levelId]; }
+
+		int GetNoHierarchyLevels() const { return viewHierarchy_Depth->GetNoLevels(); }
+
 		ITMExtendedTracker(Vector2i imgSize_d,
 						   Vector2i imgSize_rgb,
 						   bool useDepth,
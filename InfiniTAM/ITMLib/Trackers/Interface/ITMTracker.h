@@ -36,5 +36,21 @@ namespace ITMLib
 		virtual bool requiresPointCloudRendering() const = 0;
 
 		virtual ~ITMTracker(void) {}
+
+	protected:
+		/** Size of the correction from a predicted to a tracked
+		    pose, as the length of the translation and rotation
+		    vector of the transformation between them.
+		*/
+		static float ComputePoseUpdate(const Matrix4f &predictedInvPose, const Matrix4f &trackedPose)
+		{
+			ORUtils::SE3Pose update;
+			update.SetM(trackedPose * predictedInvPose);
+
+			Vector3f translation, rotation;
+			update.GetParams(translation, rotation);
+
+			return sqrtf(dot(translation, translation) + dot(rotation, rotation));
+		}
 	};
 }
@@ -4,17 +4,99 @@
 
 #include "../../Utils/ITMPixelUtils.h"
 
+/// Jacobian row of a view point, already transformed into the scene frame, for the scene normal it is matched to
 template<bool shortIteration, bool rotationOnly>
-_CPU_AND_GPU_CODE_ inline bool computePerPointGH_Depth_Ab(THREADPTR(float) *A, THREADPTR(float) &b,
-	const THREADPTR(int) & x, const THREADPTR(int) & y,
-	const CONSTPTR(float) &depth, const CONSTPTR(Vector2i) & viewImageSize, const CONSTPTR(Vector4f) & viewIntrinsics, const CONSTPTR(Vector2i) & sceneImageSize,
-	const CONSTPTR(Vector4f) & sceneIntrinsics, const CONSTPTR(Matrix4f) & approxInvPose, const CONSTPTR(Matrix4f) & scenePose, const CONSTPTR(Vector4f) *pointsMap,
-	const CONSTPTR(Vector4f) *normalsMap, float distThresh)
+_CPU_AND_GPU_CODE_ inline void computePerPointGH_Depth_Jacobian(THREADPTR(float) *A, const THREADPTR(Vector4f) & tmp3Dpoint, const THREADPTR(Vector4f) & corr3Dnormal)
+{
+	// TODO check whether normal matches normal from image, done in the original paper, but does not seem to be required
+	if (shortIteration)
+	{
+		if (rotationOnly)
+		{
+			A[0] = +tmp3Dpoint.z * corr3Dnormal.y - tmp3Dpoint.y * corr3Dnormal.z;
+			A[1] = -tmp3Dpoint.z * corr3Dnormal.x + tmp3Dpoint.x * corr3Dnormal.z;
+			A[2] = +tmp3Dpoint.y * corr3Dnormal.x - tmp3Dpoint.x * corr3Dnormal.y;
+		}
+		else { A[0] = corr3Dnormal.x; A[1] = corr3Dnormal.y; A[2] = corr3Dnormal.z; }
+	}
+	else
+	{
+		A[0] = +tmp3Dpoint.z * corr3Dnormal.y - tmp3Dpoint.y * corr3Dnormal.z;
+		A[1] = -tmp3Dpoint.z * corr3Dnormal.x + tmp3Dpoint.x * corr3Dnormal.z;
+		A[2] = +tmp3Dpoint.y * corr3Dnormal.x - tmp3Dpoint.x * corr3Dnormal.y;
+		A[!shortIteration ? 3 : 0] = corr3Dnormal.x; A[!shortIteration ? 4 : 1] = corr3Dnormal.y; A[!shortIteration ? 5 : 2] = corr3Dnormal.z;
+	}
+}
+
+/** Residual and Jacobian row of a view point, already transformed
+    into the scene frame, against the scene point and normal that
+    are interpolated at its projection tmp2Dpoint.
+*/
+template<bool shortIteration, bool rotationOnly>
+_CPU_AND_GPU_CODE_ inline bool computePerPointGH_Depth_Ab_Correspondence(THREADPTR(float) *A, THREADPTR(float) &b,
+	const THREADPTR(Vector4f) & tmp3Dpoint, const THREADPTR(Vector2f) & tmp2Dpoint, const CONSTPTR(Vector2i) & sceneImageSize,
+	const CONSTPTR(Vector4f) *pointsMap, const CONSTPTR(Vector4f) *normalsMap, float distThresh)
+{
+	Vector4f curr3Dpoint, corr3Dnormal; Vector3f ptDiff;
+
+	curr3Dpoint = interpolateBilinear_withHoles(pointsMap, tmp2Dpoint, sceneImageSize);
+	if (curr3Dpoint.w < 0.0f) return false;
+
+	ptDiff.x = curr3Dpoint.x - tmp3Dpoint.x;
+	ptDiff.y = curr3Dpoint.y - tmp3Dpoint.y;
+	ptDiff.z = curr3Dpoint.z - tmp3Dpoint.z;
+	float dist = ptDiff.x * ptDiff.x + ptDiff.y * ptDiff.y + ptDiff.z * ptDiff.z;
+
+	if (dist > distThresh) return false;
+
+	corr3Dnormal = interpolateBilinear_withHoles(normalsMap, tmp2Dpoint, sceneImageSize);
+//	if (corr3Dnormal.w < 0.0f) return false;
+
+	b = corr3Dnormal.x * ptDiff.x + corr3Dnormal.y * ptDiff.y + corr3Dnormal.z * ptDiff.z;
+
+	computePerPointGH_Depth_Jacobian<shortIteration, rotationOnly>(A, tmp3Dpoint, corr3Dnormal);
+
+	return true;
+}
+
+/** Residual and Jacobian row of a view point, already transformed
+    into the scene frame, against a scene point and normal it was
+    matched to before, at a slightly different pose.
+*/
+template<bool shortIteration, bool rotationOnly>
+_CPU_AND_GPU_CODE_ inline bool computePerPointGH_Depth_Ab_Matched(THREADPTR(float) *A, THREADPTR(float) &b,
+	const THREADPTR(Vector4f) & tmp3Dpoint, const CONSTPTR(Vector4f) & curr3Dpoint, const CONSTPTR(Vector4f) & corr3Dnormal, float distThresh)
+{
+	if (curr3Dpoint.w < 0.0f) return false;
+
+	Vector3f ptDiff;
+	ptDiff.x = curr3Dpoint.x - tmp3Dpoint.x;
+	ptDiff.y = curr3Dpoint.y - tmp3Dpoint.y;
+	ptDiff.z = curr3Dpoint.z - tmp3Dpoint.z;
+	float dist = ptDiff.x * ptDiff.x + ptDiff.y * ptDiff.y + ptDiff.z * ptDiff.z;
+
+	if (dist > distThresh) return false;
+
+	b = corr3Dnormal.x * ptDiff.x + corr3Dnormal.y * ptDiff.y + corr3Dnormal.z * ptDiff.z;
+
+	computePerPointGH_Depth_Jacobian<shortIteration, rotationOnly>(A, tmp3Dpoint, corr3Dnormal);
+
+	return true;
+}
+
+/** Back-projects a view pixel, transforms it into the scene frame
+    as tmp3Dpoint and projects it into the scene image as
+    tmp2Dpoint. Fails for invalid depths and for points that do not
+    project into the scene image.
+*/
+_CPU_AND_GPU_CODE_ inline bool computePerPointProjection_Depth(THREADPTR(Vector4f) & tmp3Dpoint, THREADPTR(Vector2f) & tmp2Dpoint,
+	const THREADPTR(int) & x, const THREADPTR(int) & y, const CONSTPTR(float) &depth, const CONSTPTR(Vector4f) & viewIntrinsics,
+	const CONSTPTR(Vector2i) & sceneImageSize, const CONSTPTR(Vector4f) & sceneIntrinsics, const CONSTPTR(Matrix4f) & approxInvPose,
+	const CONSTPTR(Matrix4f) & scenePose)
 {
 	if (depth <= 1e-8f) return false; //check if valid -- != 0.0f
 
-	Vector4f tmp3Dpoint, tmp3Dpoint_reproj; Vector3f ptDiff;
-	Vector4f curr3Dpoint, corr3Dnormal; Vector2f tmp2Dpoint;
+	Vector4f tmp3Dpoint_reproj;
 
 	tmp3Dpoint.x = depth * ((float(x) - viewIntrinsics.z) / viewIntrinsics.x);
 	tmp3Dpoint.y = depth * ((float(y) - viewIntrinsics.w) / viewIntrinsics.y);
@@ -31,44 +113,22 @@ _CPU_AND_GPU_CODE_ inline bool computePerPointGH_Depth_Ab(THREADPTR(float) *A, T
 	tmp2Dpoint.x = sceneIntrinsics.x * tmp3Dpoint_reproj.x / tmp3Dpoint_reproj.z + sceneIntrinsics.z;
 	tmp2Dpoint.y = sceneIntrinsics.y * tmp3Dpoint_reproj.y / tmp3Dpoint_reproj.z + sceneIntrinsics.w;
 
-	if (!((tmp2Dpoint.x >= 0.0f) && (tmp2Dpoint.x <= sceneImageSize.x - 2) && (tmp2Dpoint.y >= 0.0f) && (tmp2Dpoint.y <= sceneImageSize.y - 2)))
-		return false;
-
-	curr3Dpoint = interpolateBilinear_withHoles(pointsMap, tmp2Dpoint, sceneImageSize);
-	if (curr3Dpoint.w < 0.0f) return false;
-
-	ptDiff.x = curr3Dpoint.x - tmp3Dpoint.x;
-	ptDiff.y = curr3Dpoint.y - tmp3Dpoint.y;
-	ptDiff.z = curr3Dpoint.z - tmp3Dpoint.z;
-	float dist = ptDiff.x * ptDiff.x + ptDiff.y * ptDiff.y + ptDiff.z * ptDiff.z;
-
-	if (dist > distThresh) return false;
-
-	corr3Dnormal = interpolateBilinear_withHoles(normalsMap, tmp2Dpoint, sceneImageSize);
-//	if (corr3Dnormal.w < 0.0f) return false;
+	return (tmp2Dpoint.x >= 0.0f) && (tmp2Dpoint.x <= sceneImageSize.x - 2) && (tmp2Dpoint.y >= 0.0f) && (tmp2Dpoint.y <= sceneImageSize.y - 2);
+}
 
-	b = corr3Dnormal.x * ptDiff.x + corr3Dnormal.y * ptDiff.y + corr3Dnormal.z * ptDiff.z;
+template<bool shortIteration, bool rotationOnly>
+_CPU_AND_GPU_CODE_ inline bool computePerPointGH_Depth_Ab(THREADPTR(float) *A, THREADPTR(float) &b,
+	const THREADPTR(int) & x, const THREADPTR(int) & y,
+	const CONSTPTR(float) &depth, const CONSTPTR(Vector2i) & viewImageSize, const CONSTPTR(Vector4f) & viewIntrinsics, const CONSTPTR(Vector2i) & sceneImageSize,
+	const CONSTPTR(Vector4f) & sceneIntrinsics, const CONSTPTR(Matrix4f) & approxInvPose, const CONSTPTR(Matrix4f) & scenePose, const CONSTPTR(Vector4f) *pointsMap,
+	const CONSTPTR(Vector4f) *normalsMap, float distThresh)
+{
+	Vector4f tmp3Dpoint; Vector2f tmp2Dpoint;
 
-	// TODO check whether normal matches normal from image, done in the original paper, but does not seem to be required
-	if (shortIteration)
-	{
-		if (rotationOnly)
-		{
-			A[0] = +tmp3Dpoint.z * corr3Dnormal.y - tmp3Dpoint.y * corr3Dnormal.z;
-			A[1] = -tmp3Dpoint.z * corr3Dnormal.x + tmp3Dpoint.x * corr3Dnormal.z;
-			A[2] = +tmp3Dpoint.y * corr3Dnormal.x - tmp3Dpoint.x * corr3Dnormal.y;
-		}
-		else { A[0] = corr3Dnormal.x; A[1] = corr3Dnormal.y; A[2] = corr3Dnormal.z; }
-	}
-	else
-	{
-		A[0] = +tmp3Dpoint.z * corr3Dnormal.y - tmp3Dpoint.y * corr3Dnormal.z;
-		A[1] = -tmp3Dpoint.z * corr3Dnormal.x + tmp3Dpoint.x * corr3Dnormal.z;
-		A[2] = +tmp3Dpoint.y * corr3Dnormal.x - tmp3Dpoint.x * corr3Dnormal.y;
-		A[!shortIteration ? 3 : 0] = corr3Dnormal.x; A[!shortIteration ? 4 : 1] = corr3Dnormal.y; A[!shortIteration ? 5 : 2] = corr3Dnormal.z;
-	}
+	if (!computePerPointProjection_Depth(tmp3Dpoint, tmp2Dpoint, x, y, depth, viewIntrinsics, sceneImageSize, sceneIntrinsics, approxInvPose, scenePose))
+		return false;
 
-	return true;
+	return computePerPointGH_Depth_Ab_Correspondence<shortIteration, rotationOnly>(A, b, tmp3Dpoint, tmp2Dpoint, sceneImageSize, pointsMap, normalsMap, distThresh);
 }
 
 template<bool shortIteration, bool rotationOnly>
@@ -0,0 +1,86 @@
+// Copyright 2014-2017 Oxford University Innovation Limited and the authors of InfiniTAM
+
+#include "ITMBackgroundWorker.h"
+
+#include <exception>
+#include <stdio.h>
+
+#ifndef NO_CPP11
+#include <atomic>
+#include <thread>
+#endif
+
+using namespace ITMLib;
+
+struct ITMBackgroundWorker::PrivateData
+{
+#ifndef NO_CPP11
+	PrivateData(void) : busy(false) { }
+	std::thread workerThread;
+	std::atomic<bool> busy;
+#endif
+};
+
+/// Runs and deletes the task; an exception would otherwise terminate the whole process from the worker thread
+static void runTask(ITMBackgroundWorker::Task *task)
+{
+	try
+	{
+		task->Run();
+	}
+	catch (const std::exception &e)
+	{
+		fprintf(stderr, "background task failed: %s\n", e.what());
+	}
+
+	delete task;
+}
+
+#ifndef NO_CPP11
+static void workerThreadMain(ITMBackgroundWorker::Task *task, std::atomic<bool> *busy)
+{
+	runTask(task);
+	*busy = false;
+}
+#endif
+
+ITMBackgroundWorker::ITMBackgroundWorker(void)
+{
+	privateData = new PrivateData();
+}
+
+ITMBackgroundWorker::~ITMBackgroundWorker(void)
+{
+	Wait();
+	delete privateData;
+}
+
+bool ITMBackgroundWorker::Start(Task *task)
+{
+#ifndef NO_CPP11
+	if (privateData->busy) return false;
+	if (privateData->workerThread.joinable()) privateData->workerThread.join();
+
+	privateData->busy = true;
+	privateData->workerThread = std::thread(workerThreadMain, task, &privateData->busy);
+#else
+	runTask(task);
+#endif
+	return true;
+}
+
+bool ITMBackgroundWorker::IsBusy(void) const
+{
+#ifndef NO_CPP11
+	return privateData->busy;
+#else
+	return false;
+#endif
+}
+
+void ITMBackgroundWorker::Wait(void)
+{
+#ifndef NO_CPP11
+	if (privateData->workerThread.joinable()) privateData->workerThread.join();
+#endif
+}
@@ -0,0 +1,46 @@
+// Copyright 2014-2017 Oxford University Innovation Limited and the authors of InfiniTAM
+
+#pragma once
+
+namespace ITMLib
+{
+	/** \brief
+	    Runs one task at a time on a separate thread, e.g. to export a
+	    snapshot of the scene while frames keep being processed.
+	    Without C++11 support, tasks run synchronously in Start().
+	*/
+	class ITMBackgroundWorker
+	{
+	public:
+		class Task
+		{
+		public:
+			virtual void Run(void) = 0;
+			virtual ~Task(void) { }
+		};
+
+	private:
+		struct PrivateData;
+		PrivateData *privateData;
+
+	public:
+		/** Runs the task on the worker thread and deletes it once it
+		    has finished. Returns false, leaving the task to the
+		    caller, while the previous task is still running.
+		*/
+		bool Start(Task *task);
+
+		/// Whether a task is still running
+		bool IsBusy(void) const;
+
+		/// Waits for the running task, if any, to finish
+		void Wait(void);
+
+		ITMBackgroundWorker(void);
+		~ITMBackgroundWorker(void);
+
+		// Suppress the default copy constructor and assignment operator
+		ITMBackgroundWorker(const ITMBackgroundWorker&);
+		ITMBackgroundWorker& operator=(const ITMBackgroundWorker&);
+	};
+}
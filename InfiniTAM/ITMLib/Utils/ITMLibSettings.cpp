@@ -17,6 +17,19 @@ ITMLibSettings::ITMLibSettings(void)
 	// - uses additional memory (lots!)
 	createMeshingEngine = true;
 
+	/// collapse the many small planar triangles of marching cubes before meshes are written as PLY,
+	/// down to a fraction of the faces (0 for no budget) and without moving the surface further than the error (0 for no bound)
+	decimateMeshes = false;
+	meshDecimationRatio = 0.0f;
+	meshDecimationMaxError = 0.001f;
+
+	/// write meshes of the whole scene a batch of blocks at a time, for scenes whose mesh does not fit into memory;
+	/// PLY files are then written as triangle soup, without normals and without decimation
+	streamMeshes = false;
+
+	/// in the loop closure version, mesh space seen by several local maps from the earliest of them only, instead of once per map
+	deduplicateMapOverlaps = false;
+
 #ifndef COMPILE_WITHOUT_CUDA
 	deviceType = DEVICE_CUDA;
 #else
@@ -35,12 +48,24 @@ ITMLibSettings::ITMLibSettings(void)
 	/// enables or disables approximate raycast
 	useApproximateRaycast = false;
 
+	/// raycast only every n-th pixel (1, 2 or 4) when rendering the maps for ICP tracking, the other pixels are interpolated
+	icpRaycastSubsample = 1;
+
 	/// enable or disable bilateral depth filtering
 	useBilateralFilter = false;
 
+	/// start tracking each frame from the pose predicted by repeating the previous motion (constant velocity),
+	/// or a fraction of it (decaying velocity), instead of from the previous pose
+	motionModel = MOTIONMODEL_NONE;
+	motionModelDecay = 0.5f;
+
 	/// what to do on tracker failure: ignore, relocalise or stop integration - not supported in loop closure version
 	behaviourOnFailure = FAILUREMODE_IGNORE;
 
+	/// when relocalising, also track from the last good pose and from the next most similar keyframes, keeping the best result
+	useMultiHypothesisRelocalisation = false;
+	noRelocalisationHypotheses = 4;
+
 	/// switch between various library modes - basic, with loop closure, etc.
 	libMode = LIBMODE_BASIC;
 	//libMode = LIBMODE_BASIC_SURFELS;
@@ -32,6 +32,13 @@ namespace ITMLib
 			SWAPPINGMODE_DELETE
 		} SwappingMode;
 
+		typedef enum
+		{
+			MOTIONMODEL_NONE,
+			MOTIONMODEL_CONSTANT_VELOCITY,
+			MOTIONMODEL_DECAYING_VELOCITY
+		} MotionModel;
+
 		typedef enum
 		{
 			LIBMODE_BASIC,
@@ -44,14 +51,37 @@ namespace ITMLib
 
 		bool useApproximateRaycast;
 
+		/// Raycast the ICP maps at every n-th pixel only and interpolate the rest, except near depth discontinuities.
+		int icpRaycastSubsample;
+
 		bool useBilateralFilter;
 
 		/// For ITMColorTracker: skip every other point in energy function evaluation.
 		bool skipPoints;
 
 		bool createMeshingEngine;
+
+		/// Simplify meshes before they are written as PLY, to at most meshDecimationRatio of their faces and within meshDecimationMaxError metres
+		bool decimateMeshes;
+		float meshDecimationRatio, meshDecimationMaxError;
+
+		/// Write meshes of the whole scene while they are extracted, so that memory use does not grow with the mesh
+		bool streamMeshes;
+
+		/// For the loop closure version: mesh regions covered by several local maps only once
+		bool deduplicateMapOverlaps;
         
+		/// Predict the pose of each frame from the motion over the previous one before it is tracked
+		MotionModel motionModel;
+		/// Fraction of the previous motion predicted by MOTIONMODEL_DECAYING_VELOCITY
+		float motionModelDecay;
+
 		FailureMode behaviourOnFailure;
+		/// For FAILUREMODE_RELOCALISE: track from several candidate poses when relocalising and keep the best one
+		bool useMultiHypothesisRelocalisation;
+		/// Number of the most similar keyframes that are tried as candidate poses
+		int noRelocalisationHypotheses;
+
 		SwappingMode swappingMode;
 		LibMode libMode;
 
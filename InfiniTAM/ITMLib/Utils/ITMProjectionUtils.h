@@ -27,3 +27,12 @@ template<typename T> _CPU_AND_GPU_CODE_ inline Vector3f unproject(const THREADPT
 					depth * (((float)y - intrinsics.w) / intrinsics.y),
 					depth);
 }
+
+/// Unit viewing ray of pixel (x, y) in camera coordinates, with the distance along the ray per unit of depth in w.
+/// invProjParams are (1/fx, 1/fy, -cx, -cy), as the per-pixel ray tables of ITMRenderState and the raycasts use them.
+_CPU_AND_GPU_CODE_ inline Vector4f computeRayDirection(int x, int y, const THREADPTR(Vector4f) &invProjParams)
+{
+	Vector3f direction(((float)x + invProjParams.z) * invProjParams.x, ((float)y + invProjParams.w) * invProjParams.y, 1.0f);
+	float norm = sqrt(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+	return Vector4f(direction / norm, norm);
+}